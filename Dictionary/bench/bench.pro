@@ -0,0 +1,23 @@
+QT = core concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = dictbench
+
+# 与界面程序共用查找引擎和加载器，不链接 widgets
+include(../core.pri)
+
+SOURCES += \
+    enginebench.cpp \
+    main.cpp \
+    scaling.cpp \
+    synthdict.cpp \
+    verify.cpp
+
+HEADERS += \
+    enginebench.h \
+    report.h \
+    scaling.h \
+    synthdict.h \
+    verify.h
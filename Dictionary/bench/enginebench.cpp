@@ -0,0 +1,366 @@
+#include "enginebench.h"
+#include "perfcounter.h"
+#include "report.h"
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+static vector<string> distinctWords(const DictionaryIndex& index) {
+    vector<string> words;
+    words.reserve(index.wordCount());
+    for (size_t i = 0; i < index.wordCount(); ++i) {
+        string_view word = index.wordAt(i).first;
+        if (i > 0 && word == index.wordAt(i - 1).first) continue;
+        words.emplace_back(word);
+    }
+    return words;
+}
+
+static bool containsWord(const DictionaryIndex& index, const string& key) {
+    size_t low = 0, high = index.wordCount();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (index.wordAt(mid).first < key) low = mid + 1;
+        else high = mid;
+    }
+    return low < index.wordCount() && index.wordAt(low).first == key;
+}
+
+QuerySet allWordsQueries(const DictionaryIndex& index, mt19937& rng) {
+    QuerySet set{"all", distinctWords(index)};
+    shuffle(set.keys.begin(), set.keys.end(), rng);
+    return set;
+}
+
+QuerySet sampleQueries(const DictionaryIndex& index, size_t count, mt19937& rng) {
+    QuerySet set{"sample", {}};
+    if (index.wordCount() == 0) return set;
+    uniform_int_distribution<size_t> pickWord(0, index.wordCount() - 1);
+    set.keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) set.keys.emplace_back(index.wordAt(pickWord(rng)).first);
+    return set;
+}
+
+QuerySet missQueries(const DictionaryIndex& index, size_t count, mt19937& rng) {
+    QuerySet set{"miss", {}};
+    if (index.wordCount() == 0) return set;
+    uniform_int_distribution<size_t> pickWord(0, index.wordCount() - 1);
+    uniform_int_distribution<int> pickLetter('a', 'z');
+    set.keys.reserve(count);
+    // 大多数改动都不在词表中，尝试次数设上限以免词表极小时死循环
+    for (size_t attempts = 0; set.keys.size() < count && attempts < count * 20; ++attempts) {
+        string key(index.wordAt(pickWord(rng)).first);
+        if (key.empty()) continue;
+        // 首字母不变，树上的查找仍落在同一个分片里走到叶子
+        if (key.size() > 1 && rng() % 2) key[1 + rng() % (key.size() - 1)] = char(pickLetter(rng));
+        else key += char(pickLetter(rng));
+        if (!containsWord(index, key)) set.keys.push_back(std::move(key));
+    }
+    return set;
+}
+
+QuerySet zipfQueries(const DictionaryIndex& index, size_t count, double exponent, mt19937& rng) {
+    QuerySet set{"zipf", {}};
+    vector<string> words = distinctWords(index);
+    if (words.empty()) return set;
+    shuffle(words.begin(), words.end(), rng);
+    vector<double> cumulative(words.size());
+    double total = 0;
+    for (size_t r = 0; r < words.size(); ++r) {
+        total += 1.0 / pow(double(r + 1), exponent);
+        cumulative[r] = total;
+    }
+    uniform_real_distribution<double> uniform(0, total);
+    set.keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t r = lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+        set.keys.push_back(words[min(r, words.size() - 1)]);
+    }
+    return set;
+}
+
+const char* operationName(BenchOperation operation) {
+    switch (operation) {
+    case BenchOperation::Exact: return "exact";
+    case BenchOperation::ExactPath: return "exact-path";
+    case BenchOperation::Prefix: return "prefix";
+    }
+    return "";
+}
+
+bool operationFromName(const QString& name, BenchOperation& operation) {
+    for (BenchOperation op : {BenchOperation::Exact, BenchOperation::ExactPath, BenchOperation::Prefix}) {
+        if (name == operationName(op)) {
+            operation = op;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const pair<Engine, const char*> kEngineIds[] = {
+    {Engine::Sequential, "sequential"}, {Engine::SortedArray, "sorted"}, {Engine::BST, "bst"},
+    {Engine::AVL, "avl"},               {Engine::RB, "rb"},              {Engine::Eytzinger, "eytzinger"},
+    {Engine::Trie, "trie"},
+};
+
+const char* engineId(Engine engine) {
+    for (const auto& [e, id] : kEngineIds) {
+        if (e == engine) return id;
+    }
+    return "";
+}
+
+bool engineFromId(const QString& id, Engine& engine) {
+    for (const auto& [e, name] : kEngineIds) {
+        if (id == name) {
+            engine = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+using PrefixFn = function<size_t(const string& prefix)>;
+
+static bool supportsExact(Engine engine) {
+    switch (engine) {
+    case Engine::Sequential:
+    case Engine::SortedArray:
+    case Engine::BST:
+    case Engine::AVL:
+    case Engine::RB:
+    case Engine::Eytzinger: return true;
+    case Engine::Trie:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return false;
+}
+
+static PrefixFn prefixSearch(const DictionaryIndex& d, Engine engine) {
+    switch (engine) {
+    case Engine::Sequential: return [&d](const string& p) { return d.prefixSearchSequential(p).size(); };
+    case Engine::SortedArray: return [&d](const string& p) { return d.prefixSearchSorted(p).size(); };
+    case Engine::BST:
+        return [&d](const string& p) { return d.prefixSearchBST(d.bstRoot(DictionaryIndex::shardOf(p)), p).size(); };
+    case Engine::AVL:
+        return [&d](const string& p) { return d.prefixSearchAVL(d.avlRoot(DictionaryIndex::shardOf(p)), p).size(); };
+    case Engine::RB:
+        return [&d](const string& p) { return d.prefixSearchRB(d.rbRoot(DictionaryIndex::shardOf(p)), p).size(); };
+    case Engine::Trie: return [&d](const string& p) { return d.prefixSearchTrie(p).size(); };
+    // 纠错、汉译英和后缀引擎不做前缀联想，Eytzinger 只做精确查找
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return nullptr;
+}
+
+using PrefixNodesFn = function<size_t(const string& prefix)>;
+
+// 返回一次前缀联想访问的节点数，不报告节点数的引擎为空
+static PrefixNodesFn prefixNodes(const DictionaryIndex& d, Engine engine) {
+    switch (engine) {
+    case Engine::SortedArray:
+        return [&d](const string& p) { size_t n = 0; d.prefixSearchSorted(p, 10, &n); return n; };
+    case Engine::BST:
+        return [&d](const string& p) {
+            size_t n = 0;
+            d.prefixSearchBST(d.bstRoot(DictionaryIndex::shardOf(p)), p, 10, &n);
+            return n;
+        };
+    case Engine::AVL:
+        return [&d](const string& p) {
+            size_t n = 0;
+            d.prefixSearchAVL(d.avlRoot(DictionaryIndex::shardOf(p)), p, 10, &n);
+            return n;
+        };
+    case Engine::RB:
+        return [&d](const string& p) {
+            size_t n = 0;
+            d.prefixSearchRB(d.rbRoot(DictionaryIndex::shardOf(p)), p, 10, &n);
+            return n;
+        };
+    // 顺序查找和基数树不统计节点数，其余引擎不做前缀联想
+    case Engine::Sequential:
+    case Engine::Trie:
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return nullptr;
+}
+
+// 第 q 分位（0~1），取不小于它的最近一个样本
+static double percentile(const vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t rank = size_t(ceil(q * sorted.size()));
+    return sorted[min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+bool runEngineBenchmark(const DictionaryIndex& index, Engine engine, BenchOperation operation,
+                        const QuerySet& queries, size_t maxOps, bool hardwareCounters, BenchResult& result) {
+    if (!index.isReady(engine)) return false;
+    bool exact = operation != BenchOperation::Prefix;
+    PrefixFn prefix = exact ? nullptr : prefixSearch(index, engine);
+    if (exact ? !supportsExact(engine) : !prefix) return false;
+
+    size_t ops = maxOps ? min(maxOps, queries.keys.size()) : queries.keys.size();
+    vector<string> keys;
+    keys.reserve(ops);
+    for (size_t i = 0; i < ops; ++i) {
+        const string& key = queries.keys[i];
+        if (key.empty()) continue;
+        keys.push_back(exact ? key : key.substr(0, max<size_t>(1, key.size() / 2)));
+    }
+
+    // 路径访问者在编译期选定：exact 不记录，exact-path 只记视图，都不复制字符串
+    NoPath noPath;
+    PathRecorder recorder;
+    string_view meaning;
+    size_t hits = 0;
+    auto runOne = [&](const string& key) -> size_t {
+        switch (operation) {
+        case BenchOperation::Exact: return index.search(engine, key, noPath, meaning);
+        case BenchOperation::ExactPath:
+            recorder.clear();
+            return index.search(engine, key, recorder, meaning);
+        case BenchOperation::Prefix: return prefix(key) > 0;
+        }
+        return 0;
+    };
+
+    // 先空跑一小段，让代码和树的上层进入缓存
+    for (size_t i = 0; i < min<size_t>(keys.size(), 1000); ++i) runOne(keys[i]);
+
+    vector<double> samples(keys.size());
+    auto loopStart = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto start = chrono::steady_clock::now();
+        hits += runOne(keys[i]);
+        auto end = chrono::steady_clock::now();
+        samples[i] = chrono::duration<double, nano>(end - start).count();
+    }
+    auto loopEnd = chrono::steady_clock::now();
+
+    result = {};
+    result.engine = engineId(engine);
+    result.operation = operationName(operation);
+    result.querySet = queries.name;
+    result.ops = keys.size();
+    result.hits = hits;
+    if (keys.empty()) return true;
+    double total = 0;
+    for (double sample : samples) total += sample;
+    sort(samples.begin(), samples.end());
+    result.meanNs = total / samples.size();
+    result.p50Ns = percentile(samples, 0.50);
+    result.p90Ns = percentile(samples, 0.90);
+    result.p99Ns = percentile(samples, 0.99);
+    result.maxNs = samples.back();
+    double seconds = chrono::duration<double>(loopEnd - loopStart).count();
+    result.opsPerSecond = seconds > 0 ? keys.size() / seconds : 0;
+
+    // 计数另跑一遍，不影响上面的计时。精确查找用 QueryProbe 数比较和字节，
+    // 前缀联想只有二分查找和三种树报告访问的节点数
+    if (exact) {
+        size_t comparisons = 0, nodes = 0, bytes = 0;
+        for (const string& key : keys) {
+            QueryProbe probe(key);
+            index.search(engine, key, probe, meaning);
+            comparisons += probe.comparisons();
+            nodes += probe.nodes();
+            bytes += probe.bytesCompared();
+        }
+        result.comparisons = double(comparisons) / keys.size();
+        result.nodes = double(nodes) / keys.size();
+        result.bytesCompared = double(bytes) / keys.size();
+    } else if (PrefixNodesFn counted = prefixNodes(index, engine)) {
+        size_t nodes = 0;
+        for (const string& key : keys) nodes += counted(key);
+        result.nodes = double(nodes) / keys.size();
+    }
+    if (hardwareCounters) {
+        HardwareCounters counters;
+        counters.start();
+        for (const string& key : keys) runOne(key);
+        HardwareCounters::Counts counts = counters.stop();
+        auto perOp = [&](PerfCounter::Event event, uint64_t count) {
+            return counters.isValid(event) ? double(count) / keys.size() : -1.0;
+        };
+        result.cycles = perOp(PerfCounter::Cycles, counts.cycles);
+        result.instructions = perOp(PerfCounter::Instructions, counts.instructions);
+        result.llcMisses = perOp(PerfCounter::LlcMisses, counts.llcMisses);
+        result.dtlbMisses = perOp(PerfCounter::DtlbMisses, counts.dtlbMisses);
+    }
+    result.memory = index.memoryUsage(engine);
+    return true;
+}
+
+static vector<Field> fieldsOf(const BenchResult& r) {
+    return {
+        {"engine", r.engine, true},
+        {"operation", r.operation, true},
+        {"queries", r.querySet, true},
+        {"ops", QString::number(r.ops), false},
+        {"hits", QString::number(r.hits), false},
+        {"mean_ns", QString::number(r.meanNs, 'f', 1), false},
+        {"p50_ns", QString::number(r.p50Ns, 'f', 1), false},
+        {"p90_ns", QString::number(r.p90Ns, 'f', 1), false},
+        {"p99_ns", QString::number(r.p99Ns, 'f', 1), false},
+        {"max_ns", QString::number(r.maxNs, 'f', 1), false},
+        {"ops_per_sec", QString::number(r.opsPerSecond, 'f', 0), false},
+        {"comparisons", optionalNumber(r.comparisons, 2), false},
+        {"nodes", optionalNumber(r.nodes, 2), false},
+        {"bytes_compared", optionalNumber(r.bytesCompared, 2), false},
+        {"cycles", optionalNumber(r.cycles, 1), false},
+        {"instructions", optionalNumber(r.instructions, 1), false},
+        {"llc_misses", optionalNumber(r.llcMisses, 3), false},
+        {"dtlb_misses", optionalNumber(r.dtlbMisses, 3), false},
+        {"engine_bytes", QString::number(r.memory.total()), false},
+        {"structure_bytes", QString::number(r.memory.structureBytes), false},
+        {"view_bytes", QString::number(r.memory.viewBytes), false},
+        {"allocator_overhead_bytes", QString::number(r.memory.allocatorOverhead), false},
+        {"shard_map_bytes", QString::number(r.memory.shardMapBytes), false},
+        {"allocations", QString::number(r.memory.allocations), false},
+        {"referenced_string_bytes", QString::number(r.memory.referencedStringBytes), false},
+        {"sso_strings", QString::number(r.memory.inlineStrings), false},
+        {"heap_strings", QString::number(r.memory.heapStrings), false},
+        {"heap_string_bytes", QString::number(r.memory.heapStringBytes), false},
+    };
+}
+
+static vector<Field> fieldsOf(const EngineTreeShape& s) {
+    return {
+        {"engine", s.engine, true},
+        {"shard", QString::fromStdString(s.shape.shard), true},
+        {"nodes", QString::number(s.shape.nodes), false},
+        {"height", QString::number(s.shape.height), false},
+        {"optimal_height", QString::number(s.shape.optimalHeight), false},
+        {"max_depth", QString::number(s.shape.maxDepth), false},
+        {"avg_depth", QString::number(s.shape.averageDepth, 'f', 3), false},
+        {"expected_hit_comparisons", QString::number(s.shape.expectedHit, 'f', 3), false},
+        {"expected_miss_comparisons", QString::number(s.shape.expectedMiss, 'f', 3), false},
+        {"black_height", s.shape.blackHeight < 0 ? QString() : QString::number(s.shape.blackHeight), false},
+    };
+}
+
+QString resultsToCsv(const vector<BenchResult>& results) { return toCsv(results); }
+QString resultsToJson(const vector<BenchResult>& results) { return toJson(results); }
+
+vector<EngineTreeShape> collectTreeShapes(const DictionaryIndex& index) {
+    vector<EngineTreeShape> rows;
+    for (Engine engine : {Engine::BST, Engine::AVL, Engine::RB}) {
+        for (TreeShape& shape : treeShapes(index, engine)) rows.push_back({engineId(engine), std::move(shape)});
+    }
+    return rows;
+}
+
+QString treeShapesToCsv(const vector<EngineTreeShape>& shapes) { return toCsv(shapes); }
+QString treeShapesToJson(const vector<EngineTreeShape>& shapes) { return toJson(shapes); }
@@ -0,0 +1,82 @@
+#ifndef ENGINEBENCH_H
+#define ENGINEBENCH_H
+
+#include "dictionaryindex.h"
+#include "treestats.h"
+#include <QString>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+// 无界面基准程序的测量部分：在指定引擎上对一组查询逐个计时，
+// 给出每次操作的平均耗时、分位数和吞吐。计时不含查询集的生成和结果的输出
+
+struct QuerySet {
+    QString name;
+    vector<string> keys;
+};
+
+// 词表中的全部不同单词，打乱顺序
+QuerySet allWordsQueries(const DictionaryIndex& index, mt19937& rng);
+// count 个随机抽取（可重复）的词表中的单词，不必为整个词表建查询，大词表上也很快
+QuerySet sampleQueries(const DictionaryIndex& index, size_t count, mt19937& rng);
+// count 个不在词表中的单词：随机改动词表中单词的一个字母或在末尾追加一个字母
+QuerySet missQueries(const DictionaryIndex& index, size_t count, mt19937& rng);
+// count 次按 Zipf 分布抽取的单词，第 r 热的单词被抽中的概率正比于 1 / r^exponent；
+// 热度的排名是打乱后的词表顺序，与字母序无关
+QuerySet zipfQueries(const DictionaryIndex& index, size_t count, double exponent, mt19937& rng);
+
+// ExactPath 与 Exact 相同，但用 PathRecorder 记录路径
+enum class BenchOperation { Exact, ExactPath, Prefix };
+const char* operationName(BenchOperation operation); // exact、exact-path、prefix
+bool operationFromName(const QString& name, BenchOperation& operation);
+
+// 命令行和输出中使用的引擎名（sequential、sorted、bst、avl、rb、eytzinger、trie）
+const char* engineId(Engine engine);
+bool engineFromId(const QString& id, Engine& engine);
+
+struct BenchResult {
+    QString engine;
+    QString operation;
+    QString querySet;
+    size_t ops = 0;
+    size_t hits = 0;
+    double meanNs = 0;
+    double p50Ns = 0;
+    double p90Ns = 0;
+    double p99Ns = 0;
+    double maxNs = 0;
+    double opsPerSecond = 0; // 整个循环的墙钟时间折算，含每次计时本身的开销
+    // 以下为每次操作的平均值，负数表示没有测
+    double comparisons = -1;   // 键比较次数
+    double nodes = -1;         // 访问的节点数
+    double bytesCompared = -1; // 比较的字节数
+    double cycles = -1;        // 以下为硬件计数器
+    double instructions = -1;
+    double llcMisses = -1;
+    double dtlbMisses = -1;
+    // 引擎单独使用时的内存（见 DictionaryIndex::memoryUsage），与延迟放在同一行便于权衡
+    EngineMemory memory;
+};
+
+// 精确查找测 DictionaryIndex::search，前缀测 prefixSearchXxx（最多 10 条，前缀取查询词的前一半）。
+// 引擎不支持该操作或未就绪时返回 false；maxOps 非零时只取查询集的前 maxOps 个。
+// 计时之后另跑一遍统计比较次数、节点数和字节数；hardwareCounters 为真时再跑一遍读硬件计数器。
+// 最后附上引擎的内存明细
+bool runEngineBenchmark(const DictionaryIndex& index, Engine engine, BenchOperation operation,
+                        const QuerySet& queries, size_t maxOps, bool hardwareCounters, BenchResult& result);
+
+QString resultsToCsv(const vector<BenchResult>& results);
+QString resultsToJson(const vector<BenchResult>& results);
+
+// --tree-stats：各树引擎每个分片一行，每个引擎末尾是 shard 为 all 的汇总行；黑高只对红黑树有值
+struct EngineTreeShape {
+    QString engine;
+    TreeShape shape;
+};
+vector<EngineTreeShape> collectTreeShapes(const DictionaryIndex& index);
+QString treeShapesToCsv(const vector<EngineTreeShape>& shapes);
+QString treeShapesToJson(const vector<EngineTreeShape>& shapes);
+
+#endif
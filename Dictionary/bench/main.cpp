@@ -0,0 +1,215 @@
+#include "dictionaryloader.h"
+#include "enginebench.h"
+#include "scaling.h"
+#include "verify.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+// path 为空时写到标准输出
+static bool writeReport(const QString& path, const QString& report) {
+    if (path.isEmpty()) {
+        fputs(report.toUtf8().constData(), stdout);
+        return true;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        fprintf(stderr, "无法写入 %s\n", qPrintable(path));
+        return false;
+    }
+    file.write(report.toUtf8());
+    return true;
+}
+
+// 用法：dictbench [选项] EnWords.csv
+//       dictbench --generate N --output synthetic.csv [合成字典选项]
+//       dictbench --scale 100000,1000000,10000000 [合成字典选项]
+//       dictbench --verify 100000 [合成字典选项]
+// 加载字典（与界面程序相同的加载器和快照），在选定的引擎上跑选定的操作和查询集，
+// 结果以 CSV 或 JSON 写到标准输出或 --output 指定的文件，加载日志仍写到标准错误。
+// --tree-stats 时不跑基准，改为输出各树引擎分片的形状；--generate 只写出合成字典；
+// --scale 依次生成各规模的合成字典并测建立时间、查找延迟和常驻内存；
+// --verify 生成合成字典，核对各引擎的查找结果是否一致，有不一致时返回 1
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("dictbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("比较各查找引擎的精确查找和前缀联想性能");
+    parser.addHelpOption();
+    parser.addPositionalArgument("dictionary", "字典 CSV 文件（--generate、--scale 和 --verify 时不需要）");
+    QCommandLineOption enginesOption("engines", "引擎，逗号分隔：sequential,sorted,bst,avl,rb,eytzinger,trie",
+                                     "list", "sequential,sorted,bst,avl,rb,eytzinger,trie");
+    QCommandLineOption opsOption("ops", "操作，逗号分隔：exact（不记录路径）,exact-path（记录路径）,prefix", "list",
+                                 "exact,exact-path,prefix");
+    QCommandLineOption queriesOption("queries", "查询集，逗号分隔：all,sample,miss,zipf", "list", "all,miss,zipf");
+    QCommandLineOption countOption("count", "sample、miss 和 zipf 查询集的大小", "n", "100000");
+    QCommandLineOption sequentialOption("sequential-ops", "顺序查找每组最多测的次数，0 为不限", "n", "2000");
+    QCommandLineOption zipfOption("zipf", "Zipf 分布的指数", "s", "1.0");
+    QCommandLineOption seedOption("seed", "随机数种子", "n", "20240601");
+    QCommandLineOption formatOption("format", "输出格式：csv 或 json", "format", "csv");
+    QCommandLineOption outputOption("output", "输出文件，默认标准输出", "file");
+    QCommandLineOption perfOption("perf", "另跑一遍，读取周期、指令、末级缓存和 dTLB 未命中（Linux perf_event_open）");
+    QCommandLineOption treeStatsOption("tree-stats", "不跑基准，输出二叉树、AVL 树、红黑树各分片的高度、深度、"
+                                                     "期望比较次数和黑高");
+    QCommandLineOption generateOption("generate", "写出 n 条的合成字典到 --output 后退出", "n");
+    QCommandLineOption scaleOption("scale", "规模测试，逗号分隔的词条数", "list");
+    QCommandLineOption verifyOption("verify", "生成 n 条的合成字典，比较各引擎精确查找、前缀联想、拼写纠正的结果"
+                                              "和快照载入的索引，有不一致时返回 1", "n");
+    QCommandLineOption workDirOption("workdir", "规模测试和核对的合成字典所在目录，默认临时目录", "dir",
+                                     QDir::tempPath());
+    QCommandLineOption keepOption("keep", "规模测试和核对后保留合成字典");
+    QCommandLineOption keyLengthOption("key-length", "合成字典：单词的平均长度", "n", "8");
+    QCommandLineOption keyStddevOption("key-stddev", "合成字典：单词长度的标准差，0 为定长", "n", "2.5");
+    QCommandLineOption minLengthOption("min-length", "合成字典：最短单词", "n", "1");
+    QCommandLineOption maxLengthOption("max-length", "合成字典：最长单词（不超过 255）", "n", "24");
+    QCommandLineOption prefixSkewOption("prefix-skew", "合成字典：首字母的 Zipf 指数，0 为均匀", "s", "0");
+    QCommandLineOption sortednessOption("sortedness", "合成字典：1 为按单词有序，0 为完全打乱", "f", "1");
+    for (const auto& option : {enginesOption, opsOption, queriesOption, countOption, sequentialOption, zipfOption,
+                               seedOption, formatOption, outputOption, perfOption, treeStatsOption, generateOption,
+                               scaleOption, verifyOption, workDirOption, keepOption, keyLengthOption, keyStddevOption,
+                               minLengthOption, maxLengthOption, prefixSkewOption, sortednessOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    vector<Engine> engines;
+    for (const QString& id : parser.value(enginesOption).split(',', Qt::SkipEmptyParts)) {
+        Engine engine;
+        if (!engineFromId(id.trimmed(), engine)) {
+            fprintf(stderr, "未知的引擎：%s\n", qPrintable(id));
+            return 1;
+        }
+        engines.push_back(engine);
+    }
+    vector<BenchOperation> operations;
+    for (const QString& op : parser.value(opsOption).split(',', Qt::SkipEmptyParts)) {
+        BenchOperation operation;
+        if (!operationFromName(op.trimmed(), operation)) {
+            fprintf(stderr, "未知的操作：%s\n", qPrintable(op));
+            return 1;
+        }
+        operations.push_back(operation);
+    }
+    QString format = parser.value(formatOption);
+    if (format != "csv" && format != "json") {
+        fprintf(stderr, "未知的输出格式：%s\n", qPrintable(format));
+        return 1;
+    }
+
+    SyntheticOptions synthetic;
+    synthetic.meanLength = parser.value(keyLengthOption).toDouble();
+    synthetic.lengthStddev = parser.value(keyStddevOption).toDouble();
+    synthetic.minLength = parser.value(minLengthOption).toInt();
+    synthetic.maxLength = parser.value(maxLengthOption).toInt();
+    synthetic.prefixSkew = parser.value(prefixSkewOption).toDouble();
+    synthetic.sortedness = parser.value(sortednessOption).toDouble();
+    synthetic.seed = parser.value(seedOption).toUInt();
+    if (parser.isSet(generateOption)) {
+        if (!parser.isSet(outputOption)) parser.showHelp(1);
+        synthetic.entries = parser.value(generateOption).toULongLong();
+        QString error;
+        if (!writeSyntheticDictionary(parser.value(outputOption), synthetic, error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+        return 0;
+    }
+    if (parser.isSet(scaleOption)) {
+        ScalingOptions scaling;
+        for (const QString& size : parser.value(scaleOption).split(',', Qt::SkipEmptyParts)) {
+            scaling.sizes.push_back(size.trimmed().toULongLong());
+        }
+        scaling.dictionary = synthetic;
+        scaling.workDir = parser.value(workDirOption);
+        scaling.keepFiles = parser.isSet(keepOption);
+        scaling.queryCount = parser.value(countOption).toULongLong();
+        scaling.sequentialOps = parser.value(sequentialOption).toULongLong();
+        vector<ScalingResult> results;
+        QString error;
+        if (!runScalingBenchmark(scaling, results, error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+        QString report = format == "json" ? scalingToJson(results) : scalingToCsv(results);
+        return writeReport(parser.value(outputOption), report) ? 0 : 1;
+    }
+    if (parser.isSet(verifyOption)) {
+        VerifyOptions verify;
+        verify.dictionary = synthetic;
+        verify.dictionary.entries = parser.value(verifyOption).toULongLong();
+        verify.workDir = parser.value(workDirOption);
+        verify.keepFiles = parser.isSet(keepOption);
+        verify.queryCount = parser.value(countOption).toULongLong();
+        verify.sequentialOps = parser.value(sequentialOption).toULongLong();
+        vector<VerifyResult> results;
+        QString error;
+        if (!runVerification(verify, results, error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+        size_t mismatches = 0;
+        for (const VerifyResult& result : results) mismatches += result.mismatches;
+        fprintf(stderr, "核对 %zu 项，%zu 处不一致\n", results.size(), mismatches);
+        QString report = format == "json" ? verifyToJson(results) : verifyToCsv(results);
+        if (!writeReport(parser.value(outputOption), report)) return 1;
+        return mismatches == 0 ? 0 : 1;
+    }
+    if (parser.positionalArguments().size() != 1) parser.showHelp(1);
+
+    auto index = make_shared<DictionaryIndex>();
+    bool loaded = true;
+    {
+        DictionaryLoader loader(index);
+        QObject::connect(&loader, &DictionaryLoader::failed, [&](const QString& message) {
+            fprintf(stderr, "%s\n", qPrintable(message));
+            loaded = false;
+        });
+        loader.load(parser.positionalArguments().first());
+    }
+    if (!loaded) return 1;
+
+    if (parser.isSet(treeStatsOption)) {
+        vector<EngineTreeShape> shapes = collectTreeShapes(*index);
+        QString report = format == "json" ? treeShapesToJson(shapes) : treeShapesToCsv(shapes);
+        return writeReport(parser.value(outputOption), report) ? 0 : 1;
+    }
+
+    size_t count = parser.value(countOption).toULongLong();
+    mt19937 rng(parser.value(seedOption).toUInt());
+    vector<QuerySet> querySets;
+    for (const QString& name : parser.value(queriesOption).split(',', Qt::SkipEmptyParts)) {
+        if (name.trimmed() == "all") querySets.push_back(allWordsQueries(*index, rng));
+        else if (name.trimmed() == "sample") querySets.push_back(sampleQueries(*index, count, rng));
+        else if (name.trimmed() == "miss") querySets.push_back(missQueries(*index, count, rng));
+        else if (name.trimmed() == "zipf")
+            querySets.push_back(zipfQueries(*index, count, parser.value(zipfOption).toDouble(), rng));
+        else {
+            fprintf(stderr, "未知的查询集：%s\n", qPrintable(name));
+            return 1;
+        }
+    }
+
+    // 顺序查找每次都扫一遍词表，按完整的查询集跑要几十分钟，只取前 sequential-ops 个
+    size_t sequentialOps = parser.value(sequentialOption).toULongLong();
+    bool hardwareCounters = parser.isSet(perfOption);
+    vector<BenchResult> results;
+    for (const QuerySet& queries : querySets) {
+        for (BenchOperation operation : operations) {
+            for (Engine engine : engines) {
+                BenchResult result;
+                size_t maxOps = engine == Engine::Sequential ? sequentialOps : 0;
+                if (!runEngineBenchmark(*index, engine, operation, queries, maxOps, hardwareCounters, result)) continue;
+                fprintf(stderr, "%s %s %s：%.1f ns/次\n", qPrintable(result.engine), qPrintable(result.operation),
+                        qPrintable(result.querySet), result.meanNs);
+                results.push_back(result);
+            }
+        }
+    }
+
+    QString report = format == "json" ? resultsToJson(results) : resultsToCsv(results);
+    return writeReport(parser.value(outputOption), report) ? 0 : 1;
+}
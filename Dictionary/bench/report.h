@@ -0,0 +1,77 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+using namespace std;
+
+// 基准程序的 CSV / JSON 输出。每种结果行提供 fieldsOf(row) 给出各列，
+// 表头取自默认构造的一行；值为空的列在 CSV 中留空，在 JSON 中为 null
+
+struct Field {
+    const char* name;
+    QString value; // 空表示该组合没有这一项
+    bool isText;
+};
+
+// 负数表示没有测
+inline QString optionalNumber(double value, int precision) {
+    return value < 0 ? QString() : QString::number(value, 'f', precision);
+}
+
+// 含逗号、引号或换行的字段加引号，引号写两遍（RFC 4180）
+inline QString csvField(const QString& value) {
+    if (!value.contains(',') && !value.contains('"') && !value.contains('\n') && !value.contains('\r')) return value;
+    QString quoted = value;
+    quoted.replace("\"", "\"\"");
+    return "\"" + quoted + "\"";
+}
+
+// JSON 字符串：引号、反斜杠和控制字符转义，其余字符原样写出
+inline QString jsonString(const QString& value) {
+    QString escaped = "\"";
+    for (QChar c : value) {
+        switch (c.unicode()) {
+        case '"': escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        case '\t': escaped += "\\t"; break;
+        default:
+            if (c.unicode() < 0x20) escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+            else escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+template <typename Row>
+QString toCsv(const vector<Row>& rows) {
+    QStringList header;
+    for (const Field& field : fieldsOf(Row())) header.append(field.name);
+    QString csv = header.join(",") + "\n";
+    for (const Row& row : rows) {
+        QStringList values;
+        for (const Field& field : fieldsOf(row)) values.append(field.isText ? csvField(field.value) : field.value);
+        csv += values.join(",") + "\n";
+    }
+    return csv;
+}
+
+template <typename Row>
+QString toJson(const vector<Row>& rows) {
+    QString json = "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        QStringList members;
+        for (const Field& field : fieldsOf(rows[i])) {
+            QString value = field.value.isEmpty() ? "null" : field.isText ? jsonString(field.value) : field.value;
+            members.append(QString("\"%1\": %2").arg(field.name, value));
+        }
+        json += "  {" + members.join(", ") + (i + 1 < rows.size() ? "},\n" : "}\n");
+    }
+    json += "]\n";
+    return json;
+}
+
+#endif
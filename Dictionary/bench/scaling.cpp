@@ -0,0 +1,146 @@
+#include "scaling.h"
+#include "dictionaryloader.h"
+#include "enginebench.h"
+#include "memoryusage.h"
+#include "report.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+
+// 顺序查找一次要扫整个词表，每组的总比较次数限制在这个数以内，至少测 10 次；
+// 千万条时只测 20 次，十万条时与 --sequential-ops 的默认值相同
+static const size_t kSequentialComparisons = 200000000;
+
+namespace {
+struct EngineTiming {
+    double readyMs = -1;
+    double buildMs = -1;
+    double rssMegabytes = -1;
+};
+}
+
+static double milliseconds(chrono::steady_clock::duration elapsed) {
+    return chrono::duration<double, milli>(elapsed).count();
+}
+
+static bool measurePoint(const ScalingOptions& options, size_t entries, vector<ScalingResult>& results,
+                         QString& error) {
+    SyntheticOptions dictionary = options.dictionary;
+    dictionary.entries = entries;
+    QString path = QDir(options.workDir).filePath(QString("synthetic-%1.csv").arg(entries));
+    auto generateStart = chrono::steady_clock::now();
+    if (!writeSyntheticDictionary(path, dictionary, error)) return false;
+    double generateMs = milliseconds(chrono::steady_clock::now() - generateStart);
+    double csvMegabytes = QFileInfo(path).size() / (1024.0 * 1024.0);
+
+    // 索引在本函数结束时释放，下一个规模从差不多同样的常驻内存开始
+    auto index = make_shared<DictionaryIndex>();
+    size_t baseline = currentResidentBytes();
+    map<Engine, EngineTiming> timings;
+    bool loaded = true;
+    auto loadStart = chrono::steady_clock::now();
+    auto previous = loadStart;
+    {
+        DictionaryLoader loader(index);
+        loader.setSnapshotsEnabled(false);
+        loader.setAuxiliaryEnginesEnabled(false);
+        QObject::connect(&loader, &DictionaryLoader::engineReady, [&](int engine) {
+            auto now = chrono::steady_clock::now();
+            size_t resident = currentResidentBytes();
+            EngineTiming& timing = timings[static_cast<Engine>(engine)];
+            timing.readyMs = milliseconds(now - loadStart);
+            timing.buildMs = milliseconds(now - previous);
+            if (resident > 0) timing.rssMegabytes = (resident - min(resident, baseline)) / (1024.0 * 1024.0);
+            previous = now;
+        });
+        QObject::connect(&loader, &DictionaryLoader::failed, [&](const QString& message) {
+            error = message;
+            loaded = false;
+        });
+        loader.load(path);
+    }
+    double loadMs = milliseconds(chrono::steady_clock::now() - loadStart);
+    if (!options.keepFiles) QFile::remove(path);
+    if (!loaded) return false;
+
+    mt19937 rng(dictionary.seed);
+    QuerySet hits = sampleQueries(*index, options.queryCount, rng);
+    QuerySet misses = missQueries(*index, options.queryCount, rng);
+    size_t sequentialBudget = max<size_t>(10, kSequentialComparisons / max<size_t>(entries, 1));
+    size_t sequentialOps = options.sequentialOps ? min(options.sequentialOps, sequentialBudget) : sequentialBudget;
+
+    for (Engine engine : {Engine::Sequential, Engine::SortedArray, Engine::BST, Engine::AVL, Engine::RB,
+                          Engine::Eytzinger, Engine::Trie}) {
+        ScalingResult row;
+        row.entries = entries;
+        row.engine = engineId(engine);
+        row.csvMegabytes = csvMegabytes;
+        row.generateMs = generateMs;
+        row.loadMs = loadMs;
+        auto timing = timings.find(engine);
+        if (timing != timings.end()) {
+            row.readyMs = timing->second.readyMs;
+            row.buildMs = timing->second.buildMs;
+            row.rssMegabytes = timing->second.rssMegabytes;
+        }
+        if (index->isReady(engine)) row.engineMegabytes = index->memoryUsage(engine).total() / (1024.0 * 1024.0);
+
+        size_t maxOps = engine == Engine::Sequential ? sequentialOps : 0;
+        BenchResult result;
+        if (runEngineBenchmark(*index, engine, BenchOperation::Exact, hits, maxOps, false, result)) {
+            row.hitMeanNs = result.meanNs;
+            row.hitP99Ns = result.p99Ns;
+        }
+        if (runEngineBenchmark(*index, engine, BenchOperation::Exact, misses, maxOps, false, result)) {
+            row.missMeanNs = result.meanNs;
+            row.missP99Ns = result.p99Ns;
+        }
+        if (runEngineBenchmark(*index, engine, BenchOperation::Prefix, hits, maxOps, false, result)) {
+            row.prefixMeanNs = result.meanNs;
+            row.prefixP99Ns = result.p99Ns;
+        }
+        results.push_back(row);
+    }
+    return true;
+}
+
+bool runScalingBenchmark(const ScalingOptions& options, vector<ScalingResult>& results, QString& error) {
+    for (size_t entries : options.sizes) {
+        if (!measurePoint(options, entries, results, error)) return false;
+        const ScalingResult& last = results.back();
+        qInfo().noquote() << QString("规模 %1：字典 %2 MB，生成 %3 ms，加载 %4 ms")
+                                 .arg(entries)
+                                 .arg(last.csvMegabytes, 0, 'f', 1)
+                                 .arg(last.generateMs, 0, 'f', 0)
+                                 .arg(last.loadMs, 0, 'f', 0);
+    }
+    return true;
+}
+
+static vector<Field> fieldsOf(const ScalingResult& r) {
+    return {
+        {"entries", QString::number(r.entries), false},
+        {"engine", r.engine, true},
+        {"csv_mb", QString::number(r.csvMegabytes, 'f', 2), false},
+        {"generate_ms", QString::number(r.generateMs, 'f', 1), false},
+        {"load_ms", QString::number(r.loadMs, 'f', 1), false},
+        {"ready_ms", optionalNumber(r.readyMs, 1), false},
+        {"build_ms", optionalNumber(r.buildMs, 1), false},
+        {"rss_mb", optionalNumber(r.rssMegabytes, 1), false},
+        {"engine_mb", optionalNumber(r.engineMegabytes, 1), false},
+        {"hit_mean_ns", optionalNumber(r.hitMeanNs, 1), false},
+        {"hit_p99_ns", optionalNumber(r.hitP99Ns, 1), false},
+        {"miss_mean_ns", optionalNumber(r.missMeanNs, 1), false},
+        {"miss_p99_ns", optionalNumber(r.missP99Ns, 1), false},
+        {"prefix_mean_ns", optionalNumber(r.prefixMeanNs, 1), false},
+        {"prefix_p99_ns", optionalNumber(r.prefixP99Ns, 1), false},
+    };
+}
+
+QString scalingToCsv(const vector<ScalingResult>& results) { return toCsv(results); }
+QString scalingToJson(const vector<ScalingResult>& results) { return toJson(results); }
@@ -0,0 +1,46 @@
+#ifndef SCALING_H
+#define SCALING_H
+
+#include "synthdict.h"
+#include <QString>
+#include <vector>
+using namespace std;
+
+// 规模测试：对每个规模生成合成字典，加载后在各查找引擎上测精确查找和前缀联想，
+// 看建立时间、查找延迟和内存随词表大小的变化。结果每个规模、每个引擎一行，便于直接画图
+
+struct ScalingOptions {
+    vector<size_t> sizes;
+    SyntheticOptions dictionary; // entries 由 sizes 逐个替换
+    QString workDir;             // 合成字典写在这里，测完删除
+    bool keepFiles = false;
+    size_t queryCount = 100000;  // 命中、未命中、前缀各测多少次
+    size_t sequentialOps = 2000; // 顺序查找每组最多测的次数，另按词表大小缩减，见 scaling.cpp
+};
+
+struct ScalingResult {
+    size_t entries = 0;
+    QString engine;
+    double csvMegabytes = 0;
+    double generateMs = 0;
+    double loadMs = 0; // 整个加载：解析、排序、建立全部引擎
+    // 以下负数表示没有测或该引擎不支持
+    double readyMs = -1;      // 从开始加载到该引擎可查询
+    double buildMs = -1;      // 与前一个引擎就绪之间的时间，即建立这个引擎所用的时间
+    double rssMegabytes = -1; // 该引擎就绪时的常驻内存，减去加载之前的
+    double engineMegabytes = -1; // 引擎自身的结构、分配器开销和分片表（DictionaryIndex::memoryUsage）
+    double hitMeanNs = -1;
+    double hitP99Ns = -1;
+    double missMeanNs = -1;
+    double missP99Ns = -1;
+    double prefixMeanNs = -1;
+    double prefixP99Ns = -1;
+};
+
+// 加载时不读写快照，也不建拼写纠正、汉译英和后缀索引。生成或加载失败时返回 false 并给出原因
+bool runScalingBenchmark(const ScalingOptions& options, vector<ScalingResult>& results, QString& error);
+
+QString scalingToCsv(const vector<ScalingResult>& results);
+QString scalingToJson(const vector<ScalingResult>& results);
+
+#endif
@@ -0,0 +1,137 @@
+#include "synthdict.h"
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+namespace {
+
+// 英语单词首字母按常见程度的大致排名
+const char kInitialsByFrequency[] = "scpdbmatfrhielgunowvkjqyzx";
+const char* const kPartsOfSpeech[] = {"n. ", "v. ", "adj. ", "adv. "};
+
+// 单词依次放在一块缓冲区里，只记偏移和长度；千万条时比每个单词一个 std::string 省一半以上的内存
+struct KeySpan {
+    uint64_t offset : 56;
+    uint64_t length : 8;
+};
+
+void appendUtf8(string& out, uint32_t cp) {
+    out += char(0xE0 | (cp >> 12));
+    out += char(0x80 | ((cp >> 6) & 0x3F));
+    out += char(0x80 | (cp & 0x3F));
+}
+
+// 1~3 个义项，每个是 1~4 个常用区的汉字
+void appendMeaning(string& out, mt19937& rng) {
+    uniform_int_distribution<int> senses(1, 3), chars(1, 4), part(0, 3);
+    uniform_int_distribution<uint32_t> ideograph(0x4E00, 0x4E00 + 8000);
+    int count = senses(rng);
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) out += "；";
+        out += kPartsOfSpeech[part(rng)];
+        for (int n = chars(rng); n > 0; --n) appendUtf8(out, ideograph(rng));
+    }
+}
+
+// 长度在 [minLength, maxLength] 内的不同单词最多有多少个，超过 limit 时返回 limit
+double keySpace(int minLength, int maxLength, double limit) {
+    double total = 0;
+    for (int length = minLength; length <= maxLength && total < limit; ++length) total += pow(26.0, length);
+    return min(total, limit);
+}
+
+} // namespace
+
+bool writeSyntheticDictionary(const QString& path, const SyntheticOptions& options, QString& error) {
+    if (options.minLength < 1 || options.maxLength > kMaxSyntheticLength || options.minLength > options.maxLength) {
+        error = QString("单词长度范围须在 1~%1 之间").arg(kMaxSyntheticLength);
+        return false;
+    }
+    if (options.sortedness < 0 || options.sortedness > 1 || options.prefixSkew < 0) {
+        error = "sortedness 须在 0~1 之间，prefixSkew 不能为负";
+        return false;
+    }
+    // 随机生成的单词在接近键空间上限时大量重复，留出一倍余量
+    double space = keySpace(options.minLength, options.maxLength, 2.0 * options.entries);
+    if (space < 2.0 * options.entries) {
+        error = QString("长度 %1~%2 的单词最多 %3 个，不足以生成 %4 条不同的单词")
+                    .arg(options.minLength)
+                    .arg(options.maxLength)
+                    .arg(space, 0, 'f', 0)
+                    .arg(options.entries);
+        return false;
+    }
+
+    mt19937 rng(options.seed);
+    vector<double> initialWeights;
+    for (size_t rank = 1; rank <= 26; ++rank) initialWeights.push_back(1.0 / pow(double(rank), options.prefixSkew));
+    discrete_distribution<int> pickInitial(initialWeights.begin(), initialWeights.end());
+    normal_distribution<double> pickLength(options.meanLength, max(options.lengthStddev, 1e-9));
+    uniform_int_distribution<int> pickLetter('a', 'z');
+
+    string bytes;
+    vector<KeySpan> spans;
+    bytes.reserve(size_t(options.entries * max(1.0, options.meanLength)));
+    spans.reserve(options.entries);
+    auto view = [&](KeySpan span) { return string_view(bytes.data() + span.offset, span.length); };
+
+    // 生成、排序、去重，缺多少再补多少；长度分布很窄时可能要好几轮
+    for (int round = 0; spans.size() < options.entries; ++round) {
+        if (round == 16) {
+            error = QString("长度分布过窄，%1 轮后只得到 %2 个不同的单词").arg(round).arg(spans.size());
+            return false;
+        }
+        for (size_t missing = options.entries - spans.size(); missing > 0; --missing) {
+            double drawn = options.lengthStddev > 0 ? pickLength(rng) : options.meanLength;
+            int length = clamp(int(lround(drawn)), options.minLength, options.maxLength);
+            KeySpan span{bytes.size(), uint64_t(length)};
+            bytes += kInitialsByFrequency[pickInitial(rng)];
+            for (int i = 1; i < length; ++i) bytes += char(pickLetter(rng));
+            spans.push_back(span);
+        }
+        sort(spans.begin(), spans.end(), [&](KeySpan a, KeySpan b) { return view(a) < view(b); });
+        spans.erase(unique(spans.begin(), spans.end(), [&](KeySpan a, KeySpan b) { return view(a) == view(b); }),
+                    spans.end());
+    }
+
+    if (options.sortedness < 1) {
+        bernoulli_distribution displace(1 - options.sortedness);
+        uniform_int_distribution<size_t> pickPosition(0, spans.size() - 1);
+        for (size_t i = 0; i < spans.size(); ++i) {
+            if (displace(rng)) swap(spans[i], spans[pickPosition(rng)]);
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QString("无法写入 %1").arg(path);
+        return false;
+    }
+    // 攒够 1 MB 再写，避免逐行调用
+    const size_t kChunkBytes = 1 << 20;
+    string chunk;
+    chunk.reserve(kChunkBytes + 256);
+    auto writeChunk = [&]() {
+        if (file.write(chunk.data(), qint64(chunk.size())) != qint64(chunk.size())) {
+            error = QString("写入 %1 失败").arg(path);
+            return false;
+        }
+        chunk.clear();
+        return true;
+    };
+    for (KeySpan span : spans) {
+        chunk += '"';
+        chunk += view(span);
+        chunk += "\",\"";
+        appendMeaning(chunk, rng);
+        chunk += "\"\n";
+        if (chunk.size() >= kChunkBytes && !writeChunk()) return false;
+    }
+    return writeChunk();
+}
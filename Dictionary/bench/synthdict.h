@@ -0,0 +1,29 @@
+#ifndef SYNTHDICT_H
+#define SYNTHDICT_H
+
+#include <QString>
+#include <cstddef>
+
+// 合成字典：与 EnWords.csv 同为 "word","meaning" 格式，单词互不相同，只含小写字母；
+// 释义是随机汉字组成的短语（"n. 亚伃偢；v. 代偮"），汉译英的索引同样能建
+struct SyntheticOptions {
+    size_t entries = 100000;
+    // 单词长度服从截断到 [minLength, maxLength] 的正态分布，lengthStddev 为 0 时长度固定
+    double meanLength = 8;
+    double lengthStddev = 2.5;
+    int minLength = 1;
+    int maxLength = 24; // 不超过 kMaxSyntheticLength
+    // 首字母按英语单词首字母的常见程度排名（s、c、p、d……x），第 r 名的概率正比于 1 / r^prefixSkew；
+    // 0 为 26 个字母均匀，越大分片越不均
+    double prefixSkew = 0;
+    // 1 为按单词排好序，0 为完全打乱；之间的值让每条记录以 1 - sortedness 的概率与随机位置交换
+    double sortedness = 1;
+    unsigned seed = 20240601;
+};
+
+const int kMaxSyntheticLength = 255;
+
+// 生成并写出字典；参数不合法、长度范围内凑不出这么多不同单词或无法写入时返回 false 并给出原因
+bool writeSyntheticDictionary(const QString& path, const SyntheticOptions& options, QString& error);
+
+#endif
@@ -0,0 +1,312 @@
+#include "verify.h"
+#include "dictionaryloader.h"
+#include "dictionarysnapshot.h"
+#include "enginebench.h"
+#include "report.h"
+#include "treestats.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+// 每项核对最多在日志里列出这么多个不一致的查询
+static const size_t kReportedMismatches = 5;
+// 多于基数树预先排好的 10 个候选，有词频时基数树也按字典序给出，与其他引擎可比
+static const int kPrefixResults = 20;
+// 同一前缀的小字典取合成字典的前这么多个单词
+static const size_t kSharedPrefixWords = 1000;
+static const char kSharedPrefix[] = "bio";
+
+namespace {
+
+// 一次查询的结果，统一成字符串列表比较：精确查找为释义，前缀联想为单词，拼写纠正为“单词:距离”
+using Answer = vector<string>;
+using Lookup = function<Answer(const string& query)>;
+
+QString describe(const Answer& answer) {
+    if (answer.empty()) return "（无）";
+    QStringList items;
+    for (const string& item : answer) items.append(QString::fromStdString(item));
+    return items.join(" ");
+}
+
+VerifyResult compareLookups(const QString& check, const QString& engine, const QString& reference,
+                            const vector<string>& queries, const Lookup& actual, const Lookup& expected) {
+    VerifyResult row{"", check, engine, reference, queries.size(), 0};
+    for (const string& query : queries) {
+        Answer got = actual(query);
+        Answer want = expected(query);
+        if (got == want) continue;
+        if (++row.mismatches <= kReportedMismatches) {
+            qWarning().noquote() << QString("%1 %2：\"%3\" 得到 %4，%5 为 %6")
+                                        .arg(check)
+                                        .arg(engine)
+                                        .arg(QString::fromStdString(query))
+                                        .arg(describe(got))
+                                        .arg(reference)
+                                        .arg(describe(want));
+        }
+    }
+    return row;
+}
+
+Lookup exactLookup(const DictionaryIndex& index, Engine engine) {
+    return [&index, engine](const string& key) {
+        NoPath path;
+        string_view meaning;
+        if (!index.search(engine, key, path, meaning)) return Answer();
+        return Answer{string(meaning)};
+    };
+}
+
+Lookup prefixLookup(const DictionaryIndex& index, Engine engine) {
+    switch (engine) {
+    case Engine::Sequential:
+        return [&index](const string& p) { return index.prefixSearchSequential(p, kPrefixResults); };
+    case Engine::SortedArray:
+        return [&index](const string& p) { return index.prefixSearchSorted(p, kPrefixResults); };
+    case Engine::BST:
+        return [&index](const string& p) {
+            return index.prefixSearchBST(index.bstRoot(DictionaryIndex::shardOf(p)), p, kPrefixResults);
+        };
+    case Engine::AVL:
+        return [&index](const string& p) {
+            return index.prefixSearchAVL(index.avlRoot(DictionaryIndex::shardOf(p)), p, kPrefixResults);
+        };
+    case Engine::RB:
+        return [&index](const string& p) {
+            return index.prefixSearchRB(index.rbRoot(DictionaryIndex::shardOf(p)), p, kPrefixResults);
+        };
+    case Engine::Trie:
+        return [&index](const string& p) { return index.prefixSearchTrie(p, kPrefixResults); };
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return nullptr;
+}
+
+// 两种做法给出匹配的顺序不同，按词表下标排序后比较
+Lookup fuzzyLookup(const DictionaryIndex& index, bool symSpell) {
+    return [&index, symSpell](const string& word) {
+        const int maxDistance = DictionaryIndex::kMaxCorrectionDistance;
+        vector<FuzzyMatch> matches = symSpell ? index.fuzzySearchSymSpell(word, maxDistance)
+                                              : index.fuzzySearchTrie(word, maxDistance);
+        sort(matches.begin(), matches.end(),
+             [](const FuzzyMatch& a, const FuzzyMatch& b) { return a.entry < b.entry; });
+        Answer answer;
+        for (const FuzzyMatch& match : matches) {
+            answer.push_back(string(index.wordAt(match.entry).first) + ":" + to_string(match.distance));
+        }
+        return answer;
+    };
+}
+
+vector<string> head(const vector<string>& queries, size_t count) {
+    return vector<string>(queries.begin(), queries.begin() + min(count, queries.size()));
+}
+
+bool loadDictionary(const QString& path, bool snapshots, bool auxiliaryEngines, shared_ptr<DictionaryIndex>& index,
+                    QString& error) {
+    index = make_shared<DictionaryIndex>();
+    bool loaded = true;
+    DictionaryLoader loader(index);
+    loader.setSnapshotsEnabled(snapshots);
+    loader.setAuxiliaryEnginesEnabled(auxiliaryEngines);
+    QObject::connect(&loader, &DictionaryLoader::failed, [&](const QString& message) {
+        error = message;
+        loaded = false;
+    });
+    loader.load(path);
+    return loaded;
+}
+
+// 各分片的深度分布相同即树的形状相同
+VerifyResult compareShapes(Engine engine, const DictionaryIndex& actual, const DictionaryIndex& expected) {
+    vector<TreeShape> got = treeShapes(actual, engine);
+    vector<TreeShape> want = treeShapes(expected, engine);
+    VerifyResult row{"", "shape", engineId(engine), "csv", max(got.size(), want.size()), 0};
+    for (size_t i = 0; i < row.cases; ++i) {
+        if (i < got.size() && i < want.size() && got[i].shard == want[i].shard
+            && got[i].depthCounts == want[i].depthCounts) {
+            continue;
+        }
+        if (++row.mismatches <= kReportedMismatches) {
+            QString shard = QString::fromStdString(i < want.size() ? want[i].shard : got[i].shard);
+            qWarning().noquote()
+                << QString("shape %1：分片 %2 的形状与从 CSV 建立的不同").arg(engineId(engine), shard);
+        }
+    }
+    return row;
+}
+
+// 加载失败时返回 false
+bool verifySnapshot(const QString& path, const DictionaryIndex& fromCsv, const vector<string>& queries,
+                    vector<VerifyResult>& results, QString& error) {
+    // 先单独载入一次，确认快照确实可用；否则加载器会悄悄改读 CSV，下面的比较就没有意义
+    SourceStamp stamp;
+    DictionaryIndex probe;
+    if (!DictionarySnapshot::stampOf(path, stamp)
+        || !DictionarySnapshot::load(probe, DictionarySnapshot::pathFor(path), stamp)) {
+        qWarning().noquote() << "snapshot：没有写出快照或快照无法载入";
+        results.push_back({"", "snapshot", "load", "csv", 1, 1});
+        return true;
+    }
+    shared_ptr<DictionaryIndex> fromSnapshot;
+    if (!loadDictionary(path, true, false, fromSnapshot, error)) return false;
+
+    size_t count = min(fromSnapshot->wordCount(), fromCsv.wordCount());
+    VerifyResult words{"", "snapshot", "words", "csv", max(fromSnapshot->wordCount(), fromCsv.wordCount()), 0};
+    for (size_t i = 0; i < words.cases; ++i) {
+        if (i < count && fromSnapshot->wordAt(i) == fromCsv.wordAt(i)) continue;
+        if (++words.mismatches <= kReportedMismatches) {
+            qWarning().noquote() << QString("snapshot words：第 %1 条词条与从 CSV 建立的不同").arg(i);
+        }
+    }
+    results.push_back(words);
+    for (Engine engine : {Engine::SortedArray, Engine::BST, Engine::AVL, Engine::RB, Engine::Eytzinger}) {
+        results.push_back(compareLookups("snapshot", engineId(engine), "csv", queries,
+                                         exactLookup(*fromSnapshot, engine), exactLookup(fromCsv, engine)));
+    }
+    for (Engine engine : {Engine::BST, Engine::AVL, Engine::RB}) {
+        results.push_back(compareShapes(engine, *fromSnapshot, fromCsv));
+    }
+    return true;
+}
+
+// 精确查找、前缀联想和拼写纠正；顺序查找只核对 queries 和 prefixes 的前 sequentialOps 个
+void verifyEngines(const DictionaryIndex& index, const vector<string>& queries, const vector<string>& prefixes,
+                   size_t sequentialOps, size_t fuzzyOps, vector<VerifyResult>& results) {
+    results.push_back(compareLookups("exact", "sorted", "sequential", head(queries, sequentialOps),
+                                     exactLookup(index, Engine::SortedArray), exactLookup(index, Engine::Sequential)));
+    for (Engine engine : {Engine::BST, Engine::AVL, Engine::RB, Engine::Eytzinger}) {
+        results.push_back(compareLookups("exact", engineId(engine), "sorted", queries, exactLookup(index, engine),
+                                         exactLookup(index, Engine::SortedArray)));
+    }
+    results.push_back(compareLookups("prefix", "sorted", "sequential", head(prefixes, sequentialOps),
+                                     prefixLookup(index, Engine::SortedArray),
+                                     prefixLookup(index, Engine::Sequential)));
+    for (Engine engine : {Engine::BST, Engine::AVL, Engine::RB, Engine::Trie}) {
+        results.push_back(compareLookups("prefix", engineId(engine), "sorted", prefixes, prefixLookup(index, engine),
+                                         prefixLookup(index, Engine::SortedArray)));
+    }
+    results.push_back(compareLookups("fuzzy", "symspell", "trie", head(queries, fuzzyOps), fuzzyLookup(index, true),
+                                     fuzzyLookup(index, false)));
+}
+
+void tagRows(vector<VerifyResult>& results, size_t from, const QString& dictionary) {
+    for (size_t i = from; i < results.size(); ++i) results[i].dictionary = dictionary;
+}
+
+bool writeDictionary(const QString& path, const vector<pair<string, string>>& entries, QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QString("无法写入 %1").arg(path);
+        return false;
+    }
+    string text;
+    for (const auto& [word, meaning] : entries) text += "\"" + word + "\",\"" + meaning + "\"\n";
+    if (file.write(text.data(), qint64(text.size())) != qint64(text.size())) {
+        error = QString("写入 %1 失败").arg(path);
+        return false;
+    }
+    return true;
+}
+
+// 小字典上把每个单词的每个前缀都查一遍（含公共前缀本身和它的各段），另加未命中的单词
+bool verifySmallDictionary(const QString& path, const QString& name, const vector<pair<string, string>>& entries,
+                           unsigned seed, vector<VerifyResult>& results, QString& error) {
+    if (!writeDictionary(path, entries, error)) return false;
+    shared_ptr<DictionaryIndex> index;
+    bool ok = loadDictionary(path, false, true, index, error);
+    if (ok) {
+        mt19937 rng(seed);
+        vector<string> queries;
+        for (const auto& [word, meaning] : entries) {
+            for (size_t length = 1; length <= word.size(); ++length) queries.push_back(word.substr(0, length));
+        }
+        sort(queries.begin(), queries.end());
+        queries.erase(unique(queries.begin(), queries.end()), queries.end());
+        for (string& miss : missQueries(*index, entries.size(), rng).keys) queries.push_back(std::move(miss));
+        size_t from = results.size();
+        verifyEngines(*index, queries, queries, queries.size(), queries.size(), results);
+        tagRows(results, from, name);
+    }
+    QFile::remove(path);
+    return ok;
+}
+
+} // namespace
+
+bool runVerification(const VerifyOptions& options, vector<VerifyResult>& results, QString& error) {
+    QString path = QDir(options.workDir).filePath(QString("verify-%1.csv").arg(options.dictionary.entries));
+    QString snapshotPath = DictionarySnapshot::pathFor(path);
+    QFile::remove(snapshotPath);
+    if (!writeSyntheticDictionary(path, options.dictionary, error)) return false;
+
+    // 第一次加载从 CSV 建立全部引擎并写出快照
+    shared_ptr<DictionaryIndex> index;
+    bool ok = loadDictionary(path, true, true, index, error);
+    if (ok) {
+        // 命中和未命中交替排列，只取前几个时两种都有
+        mt19937 rng(options.dictionary.seed);
+        QuerySet hits = sampleQueries(*index, options.queryCount, rng);
+        QuerySet misses = missQueries(*index, options.queryCount, rng);
+        vector<string> queries;
+        for (size_t i = 0; i < max(hits.keys.size(), misses.keys.size()); ++i) {
+            if (i < hits.keys.size()) queries.push_back(hits.keys[i]);
+            if (i < misses.keys.size()) queries.push_back(misses.keys[i]);
+        }
+        vector<string> prefixes;
+        for (const string& key : queries) prefixes.push_back(key.substr(0, max<size_t>(1, key.size() / 2)));
+        size_t sequentialOps = options.sequentialOps ? options.sequentialOps : queries.size();
+        verifyEngines(*index, queries, prefixes, sequentialOps, options.fuzzyOps, results);
+
+        // 第二次加载从快照载入；加载器不读写快照时跳过
+        if (qEnvironmentVariableIsSet("DICT_NO_SNAPSHOT") || qEnvironmentVariable("DICT_BUILD_ORDER") == "insertion") {
+            qInfo() << "设置了 DICT_NO_SNAPSHOT 或逐个插入建树，不核对快照";
+        } else {
+            ok = verifySnapshot(path, *index, queries, results, error);
+        }
+        tagRows(results, 0, "synthetic");
+    }
+
+    if (ok && index->wordCount() > 0) {
+        // 合成字典的单词加上同一前缀仍然有序、互不相同
+        vector<pair<string, string>> shared;
+        for (size_t i = 0; i < index->wordCount() && shared.size() < kSharedPrefixWords; ++i) {
+            auto [word, meaning] = index->wordAt(i);
+            shared.emplace_back(kSharedPrefix + string(word), string(meaning));
+        }
+        auto [word, meaning] = index->wordAt(index->wordCount() / 2);
+        vector<pair<string, string>> single{{string(word), string(meaning)}};
+        QString directory = options.workDir;
+        ok = verifySmallDictionary(QDir(directory).filePath("verify-shared-prefix.csv"), "shared-prefix", shared,
+                                   options.dictionary.seed, results, error)
+             && verifySmallDictionary(QDir(directory).filePath("verify-single.csv"), "single", single,
+                                      options.dictionary.seed, results, error);
+    }
+    if (!options.keepFiles) {
+        QFile::remove(path);
+        QFile::remove(snapshotPath);
+    }
+    return ok;
+}
+
+static vector<Field> fieldsOf(const VerifyResult& r) {
+    return {
+        {"dictionary", r.dictionary, true},
+        {"check", r.check, true},
+        {"engine", r.engine, true},
+        {"reference", r.reference, true},
+        {"cases", QString::number(r.cases), false},
+        {"mismatches", QString::number(r.mismatches), false},
+    };
+}
+
+QString verifyToCsv(const vector<VerifyResult>& results) { return toCsv(results); }
+QString verifyToJson(const vector<VerifyResult>& results) { return toJson(results); }
@@ -0,0 +1,40 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include "synthdict.h"
+#include <QString>
+#include <vector>
+using namespace std;
+
+// 一致性核对：生成合成字典并加载，在同一组命中和未命中的查询上比较各引擎的结果。
+// 精确查找和前缀联想先用有序表对照顺序查找，其余引擎再对照有序表；
+// 拼写纠正对照 SymSpell 与基数树剪枝；快照对照从快照载入的索引与从 CSV 建立的索引。
+// 另由合成字典的单词派生两个小字典：全部单词同一前缀、只有一个单词，基数树的根在这两种情况下最容易出错
+
+struct VerifyOptions {
+    SyntheticOptions dictionary;
+    QString workDir;             // 合成字典和快照写在这里，核对完删除
+    bool keepFiles = false;
+    size_t queryCount = 100000;  // 命中、未命中各多少个
+    size_t sequentialOps = 2000; // 顺序查找每次扫整个词表，只核对这么多个查询，0 为不限
+    size_t fuzzyOps = 2000;      // 拼写纠正较慢，同样只核对这么多个
+};
+
+// 每个被核对的引擎和操作一行
+struct VerifyResult {
+    QString dictionary; // synthetic、shared-prefix、single
+    QString check;      // exact、prefix、fuzzy、snapshot、shape
+    QString engine;
+    QString reference;  // 对照的引擎
+    size_t cases = 0;
+    size_t mismatches = 0;
+};
+
+// 结果不一致不算失败，计在 mismatches 里，前几个不一致的查询写到日志。
+// 生成、加载或写快照失败时返回 false 并给出原因
+bool runVerification(const VerifyOptions& options, vector<VerifyResult>& results, QString& error);
+
+QString verifyToCsv(const vector<VerifyResult>& results);
+QString verifyToJson(const vector<VerifyResult>& results);
+
+#endif
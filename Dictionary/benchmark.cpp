@@ -0,0 +1,260 @@
+#include "benchmark.h"
+#include "fuzzysearch.h"
+#include "perfcounter.h"
+#include "stringkernels.h"
+#include <QDebug>
+#include <QString>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <type_traits>
+
+// 词表中的不同单词，打乱顺序，避免按字母序查询时路径上的节点一直留在缓存里
+static vector<string> shuffledWords(const DictionaryIndex& index) {
+    vector<string> keys;
+    keys.reserve(index.wordCount());
+    for (size_t i = 0; i < index.wordCount(); ++i) {
+        string_view word = index.wordAt(i).first;
+        if (i > 0 && word == index.wordAt(i - 1).first) continue;
+        keys.emplace_back(word);
+    }
+    shuffle(keys.begin(), keys.end(), mt19937(20240601));
+    return keys;
+}
+
+void runLookupBenchmark(const DictionaryIndex& index) {
+    vector<string> keys = shuffledWords(index);
+    if (keys.empty()) return;
+
+    const Engine engines[] = {Engine::SortedArray, Engine::BST, Engine::AVL, Engine::RB, Engine::Eytzinger};
+
+    qInfo().noquote() << QString("查找基准：%1 个不同单词，乱序各查一遍").arg(keys.size());
+    // 规范化键：按大写输入查回词表中的写法，这是每次查询前多出的一步
+    {
+        vector<string> upper = keys;
+        for (string& key : upper) {
+            for (char& c : key) c = char(toupper(static_cast<unsigned char>(c)));
+        }
+        size_t found = 0;
+        string canonical;
+        auto start = chrono::steady_clock::now();
+        for (const string& key : upper) found += index.canonicalWord(key, canonical);
+        auto end = chrono::steady_clock::now();
+        qInfo().noquote() << QString("  规范化键：%1 ns/次，占用 %2 KB，大写输入命中 %3/%4")
+                                 .arg(chrono::duration<double, nano>(end - start).count() / upper.size(), 0, 'f', 1)
+                                 .arg(index.normalizedKeys().memoryBytes() / 1024)
+                                 .arg(found)
+                                 .arg(upper.size());
+    }
+
+    // 每个引擎各跑两遍：纯查找（NoPath）和记录路径（PathRecorder，只存视图）
+    PerfCounter llcMisses(PerfCounter::LlcMisses);
+    auto measure = [&](Engine engine, auto& path, const QString& mode) {
+        string_view result;
+        size_t found = 0;
+        size_t pathLength = 0;
+        llcMisses.start();
+        auto start = chrono::steady_clock::now();
+        for (const string& key : keys) {
+            found += index.search(engine, key, path, result);
+            if constexpr (is_same_v<decay_t<decltype(path)>, PathRecorder>) {
+                pathLength += path.size();
+                path.clear();
+            }
+        }
+        auto end = chrono::steady_clock::now();
+        uint64_t misses = llcMisses.stop();
+
+        double ns = chrono::duration<double, nano>(end - start).count() / keys.size();
+        qInfo().noquote() << QString("  %1（%2）：%3 ns/次，%4 万次/秒，%5末级缓存未命中 %6，命中 %7/%8")
+                                 .arg(engineName(engine))
+                                 .arg(mode)
+                                 .arg(ns, 0, 'f', 1)
+                                 .arg(1e9 / ns / 1e4, 0, 'f', 1)
+                                 .arg(pathLength ? QString("平均路径 %1，").arg(double(pathLength) / keys.size(), 0, 'f', 2)
+                                                 : QString())
+                                 .arg(llcMisses.isValid() ? QString("%1 次/查找").arg(double(misses) / keys.size(), 0, 'f', 2)
+                                                          : QString("n/a"))
+                                 .arg(found)
+                                 .arg(keys.size());
+    };
+    for (Engine engine : engines) {
+        if (!index.isReady(engine)) continue;
+        // 先空跑一遍，两种方式都从热缓存开始
+        NoPath noPath;
+        string_view warm;
+        for (const string& key : keys) index.search(engine, key, noPath, warm);
+        measure(engine, noPath, "纯查找");
+        PathRecorder recorder;
+        measure(engine, recorder, "记录路径");
+        EngineMemory memory = index.memoryUsage(engine);
+        qInfo().noquote() << QString("  %1内存 %2 KB：结构 %3 KB，分配器开销 %4 KB，分片表 %5 KB")
+                                 .arg(engineName(engine))
+                                 .arg(memory.total() / 1024)
+                                 .arg(memory.structureBytes / 1024)
+                                 .arg(memory.allocatorOverhead / 1024)
+                                 .arg(memory.shardMapBytes / 1024);
+    }
+}
+
+void runPrefixBenchmark(const DictionaryIndex& index) {
+    vector<string> words = shuffledWords(index);
+    if (words.size() > 2000) words.resize(2000);
+    vector<string> keystrokes;
+    for (const string& word : words) {
+        for (size_t length = 1; length <= word.size(); ++length) keystrokes.push_back(word.substr(0, length));
+    }
+    if (keystrokes.empty()) return;
+
+    // 基数树不统计节点数，传入的计数保持为 0
+    using PrefixFn = vector<string> (*)(const DictionaryIndex&, const string&, size_t*);
+    const pair<Engine, PrefixFn> engines[] = {
+        {Engine::Trie, [](const DictionaryIndex& d, const string& p, size_t*) { return d.prefixSearchTrie(p); }},
+        {Engine::SortedArray, [](const DictionaryIndex& d, const string& p, size_t* visited) {
+             return d.prefixSearchSorted(p, 10, visited);
+         }},
+        {Engine::BST, [](const DictionaryIndex& d, const string& p, size_t* visited) {
+             return d.prefixSearchBST(d.bstRoot(DictionaryIndex::shardOf(p)), p, 10, visited);
+         }},
+        {Engine::AVL, [](const DictionaryIndex& d, const string& p, size_t* visited) {
+             return d.prefixSearchAVL(d.avlRoot(DictionaryIndex::shardOf(p)), p, 10, visited);
+         }},
+        {Engine::RB, [](const DictionaryIndex& d, const string& p, size_t* visited) {
+             return d.prefixSearchRB(d.rbRoot(DictionaryIndex::shardOf(p)), p, 10, visited);
+         }},
+    };
+
+    qInfo().noquote() << QString("联想基准：%1 个单词逐字输入，共 %2 次按键").arg(words.size()).arg(keystrokes.size());
+    if (index.hasFrequencies()) {
+        qInfo().noquote() << QString("  词频排序额外占用 %1 KB（二叉树节点 %2 KB）")
+                                 .arg(index.rankingBytes() / 1024)
+                                 .arg(index.nodeStats(Engine::BST).bytes / 1024);
+    }
+    for (const auto& [engine, prefixSearch] : engines) {
+        if (!index.isReady(engine)) continue;
+        size_t nodes = 0;
+        size_t results = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string& prefix : keystrokes) {
+            size_t visited = 0;
+            results += prefixSearch(index, prefix, &visited).size();
+            nodes += visited;
+        }
+        auto end = chrono::steady_clock::now();
+        bool ranked = engine == Engine::Trie && index.hasFrequencies();
+        qInfo().noquote() << QString("  %1：%2 µs/次按键，访问节点 %3 个/次按键，候选 %4 个/次按键")
+                                 .arg(ranked ? QString("%1（按词频）").arg(engineName(engine)) : QString(engineName(engine)))
+                                 .arg(chrono::duration<double, micro>(end - start).count() / keystrokes.size(), 0, 'f', 2)
+                                 .arg(engine == Engine::Trie ? QString("-")
+                                                             : QString("%1").arg(double(nodes) / keystrokes.size(), 0, 'f', 1))
+                                 .arg(double(results) / keystrokes.size(), 0, 'f', 1);
+    }
+}
+
+// 随机做 edits 处插入、删除、替换或相邻交换
+static string misspell(string word, int edits, mt19937& rng) {
+    for (int e = 0; e < edits; ++e) {
+        size_t at = rng() % (word.size() + 1);
+        char letter = char('a' + rng() % 26);
+        switch (rng() % 4) {
+        case 0: word.insert(word.begin() + at, letter); break;
+        case 1: if (at < word.size()) word.erase(at, 1); break;
+        case 2: if (at < word.size()) word[at] = letter; break;
+        default: if (at + 1 < word.size()) swap(word[at], word[at + 1]); break;
+        }
+    }
+    return word.empty() ? string(1, 'a') : word;
+}
+
+void runFuzzyBenchmark(const DictionaryIndex& index) {
+    const int kMaxDistance = DictionaryIndex::kMaxCorrectionDistance;
+    vector<string> words = shuffledWords(index);
+    if (words.size() > 500) words.resize(500);
+    if (words.empty() || !index.isReady(Engine::Trie) || !index.isReady(Engine::Fuzzy)) return;
+    mt19937 rng(7);
+    vector<string> queries;
+    for (const string& word : words) queries.push_back(misspell(word, 1 + rng() % 2, rng));
+
+
+    // 各做法的结果按词表下标排序后比较
+    auto entriesOf = [](vector<FuzzyMatch> matches) {
+        vector<uint32_t> entries;
+        for (const FuzzyMatch& match : matches) entries.push_back(match.entry);
+        sort(entries.begin(), entries.end());
+        return entries;
+    };
+    using FuzzyFn = function<vector<FuzzyMatch>(const string&)>;
+    const pair<QString, FuzzyFn> approaches[] = {
+        {"逐个计算", [&](const string& query) {
+             vector<FuzzyMatch> matches;
+             for (size_t i = 0; i < index.wordCount(); ++i) {
+                 string_view word = index.wordAt(i).first;
+                 if (i > 0 && word == index.wordAt(i - 1).first) continue;
+                 int distance = boundedEditDistance(query, word, kMaxDistance);
+                 if (distance <= kMaxDistance) matches.push_back({uint32_t(i), distance});
+             }
+             return matches;
+         }},
+        {"基数树剪枝", [&](const string& query) { return index.fuzzySearchTrie(query, kMaxDistance); }},
+        {"SymSpell", [&](const string& query) { return index.fuzzySearchSymSpell(query, kMaxDistance); }},
+    };
+    // 基数树剪枝复用联想用的基数树，不另占内存
+    const size_t indexBytes[] = {0, index.staticEngineBytes(Engine::Trie), index.staticEngineBytes(Engine::Fuzzy)};
+
+    qInfo().noquote() << QString("近似查找基准：%1 个拼错的单词，编辑距离 ≤ %2").arg(queries.size()).arg(kMaxDistance);
+    vector<vector<uint32_t>> reference;
+    for (size_t a = 0; a < size(approaches); ++a) {
+        size_t candidates = 0;
+        size_t disagreements = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t q = 0; q < queries.size(); ++q) {
+            vector<uint32_t> entries = entriesOf(approaches[a].second(queries[q]));
+            candidates += entries.size();
+            if (a == 0) reference.push_back(std::move(entries));
+            else disagreements += entries != reference[q];
+        }
+        auto end = chrono::steady_clock::now();
+        qInfo().noquote() << QString("  %1：%2 µs/次，候选 %3 个/次，索引 %4 KB，与逐个计算不一致 %5 次")
+                                 .arg(approaches[a].first)
+                                 .arg(chrono::duration<double, micro>(end - start).count() / queries.size(), 0, 'f', 1)
+                                 .arg(double(candidates) / queries.size(), 0, 'f', 1)
+                                 .arg(indexBytes[a] / 1024)
+                                 .arg(disagreements);
+    }
+}
+
+void runKernelBenchmark() {
+    const size_t kPairs = 4096;
+    const size_t kRounds = 256;
+    mt19937 rng(11);
+    qInfo().noquote() << QString("比较内核基准（当前使用 %1）").arg(kernelName(activeKernel()));
+    for (size_t length : {size_t(8), size_t(64), size_t(256)}) {
+        // 每对键前面相同，短键在随机位置不同，长键只在最后 4 字节内不同，逼近整串比较
+        vector<string> left(kPairs), right(kPairs);
+        for (size_t p = 0; p < kPairs; ++p) {
+            left[p].resize(length);
+            for (char& c : left[p]) c = char('a' + rng() % 26);
+            right[p] = left[p];
+            size_t at = length <= 8 ? rng() % length : length - 1 - rng() % 4;
+            right[p][at] = char('a' + (right[p][at] - 'a' + 1 + rng() % 25) % 26);
+        }
+        for (StringKernel kernel : {StringKernel::Scalar, StringKernel::Sse2, StringKernel::Avx2}) {
+            if (!kernelSupported(kernel)) continue;
+            size_t checksum = 0;
+            auto start = chrono::steady_clock::now();
+            for (size_t round = 0; round < kRounds; ++round) {
+                for (size_t p = 0; p < kPairs; ++p) {
+                    checksum += firstMismatch(kernel, left[p].data(), right[p].data(), length);
+                }
+            }
+            auto end = chrono::steady_clock::now();
+            double seconds = chrono::duration<double>(end - start).count();
+            qInfo().noquote() << QString("  %1 字节 %2：%3 百万次比较/秒（校验 %4）")
+                                     .arg(length)
+                                     .arg(kernelName(kernel))
+                                     .arg(kPairs * kRounds / seconds / 1e6, 0, 'f', 1)
+                                     .arg(checksum);
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "dictionaryindex.h"
+
+// 用词表中全部单词（打乱顺序）依次在各精确查找引擎上查一遍，不记录路径和记录路径各一遍，
+// 输出每次查找的耗时、吞吐、平均路径长度、末级缓存未命中数和引擎的内存。
+// 只在全部引擎就绪后调用；设置环境变量 DICT_BENCH 时由加载器触发
+void runLookupBenchmark(const DictionaryIndex& index);
+
+// 模拟逐字输入：对抽样单词的每个前缀各做一次联想（最多 10 条），
+// 输出各引擎每次按键的耗时和访问的节点数
+void runPrefixBenchmark(const DictionaryIndex& index);
+
+// 对抽样单词随机做 1~2 处拼写错误，比较近似查找的几种做法：
+// 逐个计算编辑距离、在基数树上剪枝、SymSpell 删除索引。输出每次查询的耗时、索引内存和结果是否一致
+void runFuzzyBenchmark(const DictionaryIndex& index);
+
+// 比较内核的微基准：短键（8 字节）和长键（64、256 字节，只在末尾不同）上各内核每秒的比较次数
+void runKernelBenchmark();
+
+#endif
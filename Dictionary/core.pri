@@ -0,0 +1,51 @@
+# 查找引擎、加载器和基准，不依赖 widgets；界面程序和 bench/ 下的基准程序共用
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# 每个树节点单独 new（旧的分配方式），用于和分块分配对比内存与分配次数
+#DEFINES += DICT_HEAP_NODES
+
+SOURCES += \
+    $$PWD/benchmark.cpp \
+    $$PWD/csvreader.cpp \
+    $$PWD/dictionaryindex.cpp \
+    $$PWD/dictionaryloader.cpp \
+    $$PWD/dictionarysnapshot.cpp \
+    $$PWD/eytzingerindex.cpp \
+    $$PWD/fuzzysearch.cpp \
+    $$PWD/mappedfile.cpp \
+    $$PWD/memoryreport.cpp \
+    $$PWD/memoryusage.cpp \
+    $$PWD/normalizedindex.cpp \
+    $$PWD/patternsearch.cpp \
+    $$PWD/perfcounter.cpp \
+    $$PWD/radixtrie.cpp \
+    $$PWD/reverseindex.cpp \
+    $$PWD/stringkernels.cpp \
+    $$PWD/stringpool.cpp \
+    $$PWD/treestats.cpp
+
+HEADERS += \
+    $$PWD/benchmark.h \
+    $$PWD/csvreader.h \
+    $$PWD/dictionaryindex.h \
+    $$PWD/dictionaryloader.h \
+    $$PWD/dictionarysnapshot.h \
+    $$PWD/eytzingerindex.h \
+    $$PWD/fuzzysearch.h \
+    $$PWD/mappedfile.h \
+    $$PWD/memoryreport.h \
+    $$PWD/memoryusage.h \
+    $$PWD/nodearena.h \
+    $$PWD/normalizedindex.h \
+    $$PWD/patternsearch.h \
+    $$PWD/perfcounter.h \
+    $$PWD/radixtrie.h \
+    $$PWD/reverseindex.h \
+    $$PWD/searchpath.h \
+    $$PWD/stringkernels.h \
+    $$PWD/stringpool.h \
+    $$PWD/treestats.h
+
+win32: LIBS += -lpsapi
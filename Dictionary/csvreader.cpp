@@ -0,0 +1,48 @@
+#include "csvreader.h"
+#include <cstring>
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+static string_view trimmed(string_view s) {
+    size_t begin = 0, end = s.size();
+    while (begin < end && isBlank(s[begin])) ++begin;
+    while (end > begin && isBlank(s[end - 1])) --end;
+    return s.substr(begin, end - begin);
+}
+
+void parseDictionaryCsv(const char* data, size_t size,
+                        vector<DictRecord>& records, vector<string_view>& malformed) {
+    static const string_view separator = "\",\"";
+    const char* p = data;
+    const char* end = data + size;
+
+    // 跳过 UTF-8 BOM
+    if (size >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+
+    // 按平均行长预留，避免反复扩容
+    records.reserve(records.size() + size / 48);
+
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        string_view line = trimmed(string_view(p, eol - p));
+        p = eol + 1;
+        if (line.empty()) continue;
+
+        // 去掉首尾引号，与原来的 line.mid(1, length - 2) 一致
+        string_view inner = line.size() >= 2 ? line.substr(1, line.size() - 2) : string_view();
+        size_t sep = inner.find(separator);
+        if (sep == string_view::npos || sep == 0) {
+            malformed.push_back(inner);
+            continue;
+        }
+
+        string_view word = inner.substr(0, sep);
+        string_view meaning = inner.substr(sep + separator.size());
+        size_t next = meaning.find(separator); // 多余的列丢弃
+        if (next != string_view::npos) meaning = meaning.substr(0, next);
+        records.push_back({word, meaning});
+    }
+}
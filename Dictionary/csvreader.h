@@ -0,0 +1,19 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 一条 "word","meaning" 记录，两个视图都指向原始文件字节
+struct DictRecord {
+    string_view word;
+    string_view meaning;
+};
+
+// 就地解析字典 CSV：不拷贝、不转码，结果只在 data 有效期内可用。
+// 缺少分隔符的行（原样去掉首尾引号后）放入 malformed
+void parseDictionaryCsv(const char* data, size_t size,
+                        vector<DictRecord>& records, vector<string_view>& malformed);
+
+#endif
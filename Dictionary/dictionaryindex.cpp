@@ -0,0 +1,823 @@
+#include "dictionaryindex.h"
+#include "stringkernels.h"
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cctype>
+
+const char* engineName(Engine engine) {
+    switch (engine) {
+    case Engine::Sequential: return "顺序查找";
+    case Engine::SortedArray: return "二分查找";
+    case Engine::Trie: return "基数树";
+    case Engine::BST: return "二叉树";
+    case Engine::AVL: return "AVL树";
+    case Engine::RB: return "红黑树";
+    case Engine::Eytzinger: return "Eytzinger布局";
+    case Engine::Fuzzy: return "近似查找";
+    case Engine::Reverse: return "汉译英";
+    case Engine::Suffix: return "后缀查找";
+    }
+    return "";
+}
+
+bool DictionaryIndex::isReady(Engine engine) const {
+    return m_readyMask.load(memory_order_acquire) & (1u << static_cast<unsigned>(engine));
+}
+
+void DictionaryIndex::markReady(Engine engine) {
+    m_readyMask.fetch_or(1u << static_cast<unsigned>(engine), memory_order_release);
+}
+
+void DictionaryIndex::setWords(vector<pair<string_view, string_view>> words) {
+    m_allWords = std::move(words);
+    auto byWord = [](const pair<string_view, string_view>& a, const pair<string_view, string_view>& b) {
+        return a.first < b.first;
+    };
+    if (!is_sorted(m_allWords.begin(), m_allWords.end(), byWord)) {
+        stable_sort(m_allWords.begin(), m_allWords.end(), byWord);
+    }
+}
+
+bool DictionaryIndex::canonicalWord(const string& query, string& word) const {
+    // 词表中有原样的写法时不改写：China 与 china 都在词表中时，查 China 得到 China
+    uint32_t entry = m_normalized.find(query);
+    if (entry == NormalizedIndex::kNotFound) return false;
+    word = m_allWords[entry].first;
+    return true;
+}
+
+size_t DictionaryIndex::setFrequencies(const vector<pair<string_view, uint64_t>>& counts) {
+    m_frequency.assign(m_allWords.size(), 0);
+    size_t matched = 0;
+    for (const auto& [word, count] : counts) {
+        // 重复的单词记在第一条上，基数树也以第一条代表这个单词
+        auto it = lower_bound(m_allWords.begin(), m_allWords.end(), word,
+                              [](const pair<string_view, string_view>& w, string_view key) { return w.first < key; });
+        if (it == m_allWords.end() || it->first != word) continue;
+        uint64_t& frequency = m_frequency[it - m_allWords.begin()];
+        if (frequency == 0) ++matched;
+        frequency = max(frequency, count);
+    }
+    return matched;
+}
+
+void DictionaryIndex::buildStaticEngine(Engine engine) {
+    if (engine == Engine::Trie) {
+        m_trie.build(m_allWords);
+        if (hasFrequencies()) m_trie.rank(m_frequency, kRankedCompletions);
+    } else if (engine == Engine::Eytzinger) {
+        m_eytzinger.build(m_allWords);
+    } else if (engine == Engine::Fuzzy) {
+        m_symSpell.build(m_allWords, kMaxCorrectionDistance);
+    } else if (engine == Engine::Reverse) {
+        m_reverse.build(m_allWords);
+    } else if (engine == Engine::Suffix) {
+        m_reversedKeys.build(m_allWords);
+    }
+}
+
+size_t DictionaryIndex::staticEngineBytes(Engine engine) const {
+    if (engine == Engine::Trie) return m_trie.memoryBytes();
+    if (engine == Engine::Eytzinger) return m_eytzinger.memoryBytes();
+    if (engine == Engine::Fuzzy) return m_symSpell.memoryBytes();
+    if (engine == Engine::Reverse) return m_reverse.memoryBytes();
+    if (engine == Engine::Suffix) return m_reversedKeys.memoryBytes();
+    return 0;
+}
+
+void DictionaryIndex::sortByWord(vector<DictRecord>& records) {
+    stable_sort(records.begin(), records.end(), [](const DictRecord& a, const DictRecord& b) {
+        return a.word < b.word;
+    });
+}
+
+map<char, vector<size_t>> DictionaryIndex::partitionByFirstChar(const vector<DictRecord>& records) {
+    map<char, vector<size_t>> shards;
+    for (size_t i = 0; i < records.size(); ++i) {
+        shards[shardOf(records[i].word)].push_back(i);
+    }
+    return shards;
+}
+
+// 一个首字母分片的建树任务，节点先放进任务自己的分配器，避免线程间争用
+struct ShardTask {
+    char firstChar;
+    const vector<size_t>* items; // records 中的下标，保持文件顺序
+    void* root;
+    NodeArena<BSTNode> bstArena;
+    NodeArena<AVLNode> avlArena;
+    NodeArena<RBNode> rbArena;
+};
+
+void DictionaryIndex::buildEngine(Engine engine, const vector<DictRecord>& records,
+                                  const map<char, vector<size_t>>& shards, BuildMode mode, BuildOrder order,
+                                  const function<void()>& shardDone) {
+    // 只有三种树按首字母分片
+    if (engine != Engine::BST && engine != Engine::AVL && engine != Engine::RB) return;
+
+    vector<ShardTask> tasks;
+    tasks.reserve(shards.size());
+    for (const auto& [firstChar, items] : shards) {
+        tasks.push_back({firstChar, &items, nullptr, {}, {}, {}});
+    }
+    // 大分片（如 's'、'c'）先开工，减少尾部只剩一个线程在跑的时间
+    stable_sort(tasks.begin(), tasks.end(), [](const ShardTask& a, const ShardTask& b) {
+        return a.items->size() > b.items->size();
+    });
+
+    // 有序分片去掉重复单词：keepLast 为真时保留最后一条（红黑树插入时后来的释义覆盖前面的）
+    auto uniqueSorted = [&](const vector<size_t>& items, bool keepLast) {
+        vector<DictRecord> unique;
+        unique.reserve(items.size());
+        for (size_t i : items) {
+            if (!unique.empty() && unique.back().word == records[i].word) {
+                if (keepLast) unique.back() = records[i];
+                continue;
+            }
+            unique.push_back(records[i]);
+        }
+        return unique;
+    };
+
+    auto buildShard = [&](ShardTask& task) {
+        // 分片的节点数不超过记录数，一次预留一整块
+        size_t count = task.items->size();
+        if (order == BuildOrder::Sorted) {
+            vector<DictRecord> unique = uniqueSorted(*task.items, engine == Engine::RB);
+            const DictRecord* first = unique.data();
+            const DictRecord* last = first + unique.size();
+            if (engine == Engine::BST) {
+                task.bstArena.reserve(unique.size());
+                task.root = buildBalancedBST(task.bstArena, first, last);
+            } else if (engine == Engine::AVL) {
+                task.avlArena.reserve(unique.size());
+                task.root = buildBalancedAVL(task.avlArena, first, last);
+            } else {
+                // 最底层不满的那一层染红，其余全黑，各路径黑高相同
+                int redDepth = 0;
+                while ((size_t(2) << redDepth) - 1 <= unique.size()) ++redDepth;
+                task.rbArena.reserve(unique.size());
+                task.root = buildBalancedRB(task.rbArena, first, last, 0, redDepth);
+            }
+            if (shardDone) shardDone();
+            return;
+        }
+        switch (engine) {
+        case Engine::BST: {
+            BSTNode* root = nullptr;
+            task.bstArena.reserve(count);
+            for (size_t i : *task.items) root = insertBST(task.bstArena, root, records[i].word, records[i].meaning);
+            task.root = root;
+            break;
+        }
+        case Engine::AVL: {
+            AVLNode* root = nullptr;
+            task.avlArena.reserve(count);
+            for (size_t i : *task.items) root = insertAVL(task.avlArena, root, records[i].word, records[i].meaning);
+            task.root = root;
+            break;
+        }
+        case Engine::RB: {
+            RBNode* root = nullptr;
+            task.rbArena.reserve(count);
+            for (size_t i : *task.items) root = insertRB(task.rbArena, root, records[i].word, records[i].meaning);
+            task.root = root;
+            break;
+        }
+        case Engine::Sequential:
+        case Engine::SortedArray:
+        case Engine::Trie:
+        case Engine::Eytzinger:
+        case Engine::Fuzzy:
+        case Engine::Reverse:
+        case Engine::Suffix:
+            break;
+        }
+        if (shardDone) shardDone();
+    };
+
+    if (mode == BuildMode::Parallel) {
+        QtConcurrent::blockingMap(tasks, buildShard);
+    } else {
+        for (ShardTask& task : tasks) buildShard(task);
+    }
+
+    // 各任务只写自己的 root 和分配器，汇总在所有任务结束后进行
+    for (ShardTask& task : tasks) {
+        switch (engine) {
+        case Engine::BST:
+            bstMap[task.firstChar] = static_cast<BSTNode*>(task.root);
+            m_bstArena.adopt(std::move(task.bstArena));
+            break;
+        case Engine::AVL:
+            avlMap[task.firstChar] = static_cast<AVLNode*>(task.root);
+            m_avlArena.adopt(std::move(task.avlArena));
+            break;
+        case Engine::RB:
+            rbMap[task.firstChar] = static_cast<RBNode*>(task.root);
+            m_rbArena.adopt(std::move(task.rbArena));
+            break;
+        case Engine::Sequential:
+        case Engine::SortedArray:
+        case Engine::Trie:
+        case Engine::Eytzinger:
+        case Engine::Fuzzy:
+        case Engine::Reverse:
+        case Engine::Suffix: break;
+        }
+    }
+}
+
+ArenaStats DictionaryIndex::nodeStats(Engine engine) const {
+    switch (engine) {
+    case Engine::BST: return m_bstArena.stats();
+    case Engine::AVL: return m_avlArena.stats();
+    case Engine::RB: return m_rbArena.stats();
+    case Engine::Sequential:
+    case Engine::SortedArray:
+    case Engine::Trie:
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return {};
+}
+
+// 每次堆分配按 8 字节头、16 字节对齐估计，与加载日志中的估计一致
+static size_t heapBlockBytes(size_t bytes) {
+    return (bytes + 8 + 15) & ~size_t(15);
+}
+
+static void countStrings(EngineMemory& memory, string_view word, string_view meaning) {
+    for (string_view text : {word, meaning}) {
+        memory.referencedStringBytes += text.size();
+        if (text.size() <= 15) {
+            ++memory.inlineStrings;
+        } else {
+            ++memory.heapStrings;
+            memory.heapStringBytes += heapBlockBytes(text.size() + 1);
+        }
+    }
+}
+
+template <typename Node>
+static EngineMemory treeMemory(const map<char, Node*>& shards, const NodeArena<Node>& arena) {
+    EngineMemory memory;
+    ArenaStats stats = arena.stats();
+    memory.structureBytes = stats.nodes * sizeof(Node);
+    memory.viewBytes = stats.nodes * 2 * sizeof(string_view);
+    memory.allocations = stats.allocations;
+    // 分块时是块尾未用的槽和每块一个分配头；DICT_HEAP_NODES 时每个节点一个分配头
+    memory.allocatorOverhead = stats.bytes - memory.structureBytes;
+    if (stats.allocations > 0) {
+        size_t blockBytes = stats.bytes / stats.allocations;
+        memory.allocatorOverhead += stats.allocations * (heapBlockBytes(blockBytes) - blockBytes);
+    }
+    // std::map 的节点：颜色和三个指针，再加上键值对
+    memory.shardMapBytes = shards.size() * heapBlockBytes(4 * sizeof(void*) + sizeof(pair<const char, Node*>));
+
+    vector<const Node*> stack;
+    for (const auto& [firstChar, root] : shards) {
+        if (root) stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        countStrings(memory, node->key, node->value);
+        if (node->left) stack.push_back(node->left);
+        if (node->right) stack.push_back(node->right);
+    }
+    return memory;
+}
+
+EngineMemory DictionaryIndex::memoryUsage(Engine engine) const {
+    EngineMemory memory;
+    switch (engine) {
+    case Engine::Sequential:
+    case Engine::SortedArray: {
+        size_t entryBytes = sizeof(m_allWords[0]);
+        size_t capacityBytes = m_allWords.capacity() * entryBytes;
+        memory.structureBytes = m_allWords.size() * entryBytes;
+        memory.viewBytes = memory.structureBytes;
+        memory.allocations = m_allWords.capacity() > 0 ? 1 : 0;
+        memory.allocatorOverhead = capacityBytes - memory.structureBytes
+                                   + (memory.allocations ? heapBlockBytes(capacityBytes) - capacityBytes : 0);
+        for (const auto& [word, meaning] : m_allWords) countStrings(memory, word, meaning);
+        break;
+    }
+    case Engine::BST: return treeMemory(bstMap, m_bstArena);
+    case Engine::AVL: return treeMemory(avlMap, m_avlArena);
+    case Engine::RB: return treeMemory(rbMap, m_rbArena);
+    case Engine::Trie:
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: memory.structureBytes = staticEngineBytes(engine); break;
+    }
+    return memory;
+}
+
+vector<char> DictionaryIndex::shardKeys() const {
+    vector<char> keys;
+    keys.reserve(bstMap.size());
+    for (const auto& [firstChar, root] : bstMap) keys.push_back(firstChar);
+    return keys;
+}
+
+BSTNode* DictionaryIndex::bstRoot(char firstChar) const {
+    auto it = bstMap.find(firstChar);
+    return it != bstMap.end() ? it->second : nullptr;
+}
+
+AVLNode* DictionaryIndex::avlRoot(char firstChar) const {
+    auto it = avlMap.find(firstChar);
+    return it != avlMap.end() ? it->second : nullptr;
+}
+
+RBNode* DictionaryIndex::rbRoot(char firstChar) const {
+    auto it = rbMap.find(firstChar);
+    return it != rbMap.end() ? it->second : nullptr;
+}
+
+vector<string> DictionaryIndex::prefixSearchSequential(const string& prefix, int maxResults) const {
+    vector<string> results;
+    for (const auto& pair : m_allWords) {
+        if (startsWith(pair.first, prefix)) {
+            results.push_back(string(pair.first));
+            if ((int)results.size() >= maxResults) break;//最多限制
+        }
+    }
+    return results;
+}
+
+vector<string> DictionaryIndex::prefixSearchSorted(const string& prefix, int maxResults, size_t* nodesVisited) const {
+    // 只比较单词的前 prefix.size() 个字节：以 prefix 开头的单词在有序表里是连续的一段
+    size_t probes = 0;
+    auto head = [&](string_view word) { return word.substr(0, prefix.size()); };
+    auto first = lower_bound(m_allWords.begin(), m_allWords.end(), prefix,
+                             [&](const pair<string_view, string_view>& w, const string& p) {
+                                 ++probes;
+                                 return compareBytes(head(w.first), p) < 0;
+                             });
+    auto last = upper_bound(first, m_allWords.end(), prefix,
+                            [&](const string& p, const pair<string_view, string_view>& w) {
+                                ++probes;
+                                return compareBytes(p, head(w.first)) < 0;
+                            });
+    vector<string> results;
+    for (auto it = first; it != last && (int)results.size() < maxResults; ++it) {
+        if (it != first && it->first == (it - 1)->first) continue;
+        results.emplace_back(it->first);
+    }
+    if (nodesVisited) *nodesVisited = probes;
+    return results;
+}
+
+// 有界的中序范围扫描：先下降到第一个 >= prefix 的节点，沿途把向左拐的节点压栈，
+// 再按中序逐个弹出，遇到第一个不以 prefix 开头的单词就停，共 O(log n + k) 个节点。
+// 栈放在本函数的数组里，平衡树的高度远小于 64；只有按文件顺序插入的退化二叉树才会溢出到堆上
+template<typename NodeT>
+static vector<string> prefixScan(const NodeT* root, string_view prefix, int maxResults, size_t* nodesVisited,
+                                 int (*compare)(string_view, string_view)) {
+    vector<string> results;
+    const NodeT* inlineStack[64];
+    vector<const NodeT*> overflow;
+    size_t depth = 0;
+    size_t visited = 0;
+    auto push = [&](const NodeT* node) {
+        if (depth < size(inlineStack)) inlineStack[depth] = node;
+        else overflow.push_back(node);
+        ++depth;
+    };
+    auto pop = [&]() {
+        --depth;
+        if (depth < size(inlineStack)) return inlineStack[depth];
+        const NodeT* node = overflow.back();
+        overflow.pop_back();
+        return node;
+    };
+    // 左边界：比 prefix 小的节点只往右走，不进栈
+    for (const NodeT* node = root; node; ++visited) {
+        if (compare(node->key, prefix) < 0) {
+            node = node->right;
+        } else {
+            push(node);
+            node = node->left;
+        }
+    }
+    while (depth > 0 && (int)results.size() < maxResults) {
+        const NodeT* node = pop();
+        if (!startsWith(node->key, prefix)) break; // 右边界
+        results.emplace_back(node->key);
+        for (const NodeT* next = node->right; next; next = next->left, ++visited) push(next);
+    }
+    if (nodesVisited) *nodesVisited = visited;
+    return results;
+}
+
+vector<string> DictionaryIndex::prefixSearchBST(BSTNode* root, const string& prefix, int maxResults,
+                                                size_t* nodesVisited) const {
+    return prefixScan(root, prefix, maxResults, nodesVisited, compareKeys);
+}
+
+vector<string> DictionaryIndex::prefixSearchAVL(AVLNode* root, const string& prefix, int maxResults,
+                                                size_t* nodesVisited) const {
+    return prefixScan(root, prefix, maxResults, nodesVisited, compareKeys);
+}
+
+vector<string> DictionaryIndex::prefixSearchRB(RBNode* root, const string& prefix, int maxResults,
+                                               size_t* nodesVisited) const {
+    return prefixScan(root, prefix, maxResults, nodesVisited, compareKeys);
+}
+
+vector<string> DictionaryIndex::prefixSearchTrie(const string& prefix, int maxResults) const {
+    return m_trie.prefixSearch(prefix, maxResults);
+}
+
+
+BSTNode* DictionaryIndex::insertBST(NodeArena<BSTNode>& arena, BSTNode* root, string_view key, string_view value) {
+    if (!root) return arena.create(key, value);
+    int comparison = compareKeys(key, root->key);
+    if (comparison < 0) {
+        root->left = insertBST(arena, root->left, key, value);
+    } else if (comparison > 0) {
+        root->right = insertBST(arena, root->right, key, value);
+    }
+    return root;
+}
+
+AVLNode* DictionaryIndex::insertAVL(NodeArena<AVLNode>& arena, AVLNode* root, string_view key, string_view value) {
+    if (!root) return arena.create(key, value);
+
+    int comparison = compareKeys(key, root->key);
+    if (comparison < 0) root->left = insertAVL(arena, root->left, key, value);
+    else if (comparison > 0) root->right = insertAVL(arena, root->right, key, value);
+    else return root;
+
+    root->height = 1 + max(getHeight(root->left), getHeight(root->right));
+    int balance = getBalance(root);
+
+    if (balance > 1 && key < root->left->key) return rotateRight(root);
+    if (balance < -1 && key > root->right->key) return rotateLeft(root);
+    if (balance > 1 && key > root->left->key) {
+        root->left = rotateLeft(root->left);
+        return rotateRight(root);
+    }
+    if (balance < -1 && key < root->right->key) {
+        root->right = rotateRight(root->right);
+        return rotateLeft(root);
+    }
+    return root;
+}
+
+BSTNode* DictionaryIndex::buildBalancedBST(NodeArena<BSTNode>& arena, const DictRecord* begin, const DictRecord* end) {
+    if (begin >= end) return nullptr;
+    const DictRecord* mid = begin + (end - begin) / 2;
+    BSTNode* node = arena.create(mid->word, mid->meaning);
+    node->left = buildBalancedBST(arena, begin, mid);
+    node->right = buildBalancedBST(arena, mid + 1, end);
+    return node;
+}
+
+AVLNode* DictionaryIndex::buildBalancedAVL(NodeArena<AVLNode>& arena, const DictRecord* begin, const DictRecord* end) {
+    if (begin >= end) return nullptr;
+    const DictRecord* mid = begin + (end - begin) / 2;
+    AVLNode* node = arena.create(mid->word, mid->meaning);
+    node->left = buildBalancedAVL(arena, begin, mid);
+    node->right = buildBalancedAVL(arena, mid + 1, end);
+    node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+    return node;
+}
+
+// 取中点建树时左右子树大小至多差 1，所有空链接都在 redDepth 或 redDepth + 1 层，
+// 深度为 redDepth 的节点就是不满的最底层
+RBNode* DictionaryIndex::buildBalancedRB(NodeArena<RBNode>& arena, const DictRecord* begin, const DictRecord* end,
+                                         int depth, int redDepth) {
+    if (begin >= end) return nullptr;
+    const DictRecord* mid = begin + (end - begin) / 2;
+    RBNode* node = arena.create(mid->word, mid->meaning);
+    node->isRed = depth == redDepth;
+    node->left = buildBalancedRB(arena, begin, mid, depth + 1, redDepth);
+    node->right = buildBalancedRB(arena, mid + 1, end, depth + 1, redDepth);
+    if (node->left) node->left->parent = node;
+    if (node->right) node->right->parent = node;
+    return node;
+}
+
+AVLNode* DictionaryIndex::rotateLeft(AVLNode* x) {
+    AVLNode* y = x->right;
+    AVLNode* T2 = y->left;
+
+    y->left = x;
+    x->right = T2;
+
+    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
+    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
+
+    return y;
+}
+
+AVLNode* DictionaryIndex::rotateRight(AVLNode* y) {
+    AVLNode* x = y->left;
+    AVLNode* T2 = x->right;
+
+    x->right = y;
+    y->left = T2;
+
+    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
+    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
+
+    return x;
+}
+
+int DictionaryIndex::getHeight(AVLNode* node) {
+    return node ? node->height : 0;
+}
+
+int DictionaryIndex::getBalance(AVLNode* node) {
+    return node ? getHeight(node->left) - getHeight(node->right) : 0;
+}
+RBNode* DictionaryIndex::insertRB(NodeArena<RBNode>& arena, RBNode* root, string_view key, string_view value) {
+    if (root == nullptr) {
+        RBNode* newNode = arena.create(key, value);
+        newNode->isRed = false;  // 根节点总是黑色
+        return newNode;
+    }
+
+    RBNode* parent = nullptr;
+    RBNode* current = root;
+
+    // 通过普通的二叉查找树找到插入位置；找到位置后才分配节点，重复关键字不占用分配器
+    while (current != nullptr) {
+        parent = current;
+        int comparison = compareKeys(key, current->key);
+        if (comparison < 0) {
+            current = current->left;
+        } else if (comparison > 0) {
+            current = current->right;
+        } else {
+            current->value = value;  // 如果关键字相等，更新值
+            return root;
+        }
+    }
+
+    // 插入新的节点
+    RBNode* newNode = arena.create(key, value);
+    // 设置父节点
+    newNode->parent = parent;
+    if (key < parent->key) {
+        parent->left = newNode;
+    } else {
+        parent->right = newNode;
+    }
+
+    // 2. 修正红黑树性质
+    return fixInsertRB(root, newNode);
+}
+
+RBNode* DictionaryIndex::fixInsertRB(RBNode* root, RBNode* node) {
+    // 如果父节点是黑色或是根节点，直接返回
+    while (node != root && node->parent->isRed == true) {
+        if (node->parent == node->parent->parent->left) { // 父节点是左子树
+            RBNode* uncle = node->parent->parent->right;
+            if (uncle && uncle->isRed == true) { // Case 1: 叔叔是红色
+                node->parent->isRed = false;      // 父节点变黑
+                uncle->isRed = false;             // 叔叔变黑
+                node->parent->parent->isRed = true; // 祖父节点变红
+                node = node->parent->parent;        // 向上调整
+            } else { // Case 2: 叔叔是黑色
+                if (node == node->parent->right) { // Case 2a: 插入的是右子节点
+                    node = node->parent;
+                    root = leftRotateRB(root, node);  // 左旋
+                }
+                node->parent->isRed = false;       // 父节点变黑
+                node->parent->parent->isRed = true; // 祖父节点变红
+                root = rightRotateRB(root, node->parent->parent); // 右旋
+            }
+        } else { // 父节点是右子树
+            RBNode* uncle = node->parent->parent->left;
+            if (uncle && uncle->isRed == true) { // Case 1: 叔叔是红色
+                node->parent->isRed = false;      // 父节点变黑
+                uncle->isRed = false;             // 叔叔变黑
+                node->parent->parent->isRed = true; // 祖父节点变红
+                node = node->parent->parent;        // 向上调整
+            } else { // Case 2: 叔叔是黑色
+                if (node == node->parent->left) { // Case 2a: 插入的是左子节点
+                    node = node->parent;
+                    root = rightRotateRB(root, node); // 右旋
+                }
+                node->parent->isRed = false;       // 父节点变黑
+                node->parent->parent->isRed = true; // 祖父节点变红
+                root = leftRotateRB(root, node->parent->parent); // 左旋
+            }
+        }
+    }
+    root->isRed = false; // 根节点必须是黑色
+    return root;
+}
+
+// 左旋操作
+RBNode* DictionaryIndex::leftRotateRB(RBNode* root, RBNode* node) {
+    RBNode* rightChild = node->right;
+    node->right = rightChild->left;
+    if (rightChild->left != nullptr) {
+        rightChild->left->parent = node;
+    }
+    rightChild->parent = node->parent;
+    if (node->parent == nullptr) {
+        root = rightChild; // 如果旋转的是根节点，更新根节点
+    } else if (node == node->parent->left) {
+        node->parent->left = rightChild;
+    } else {
+        node->parent->right = rightChild;
+    }
+    rightChild->left = node;
+    node->parent = rightChild;
+
+    return root;
+}
+
+// 右旋操作
+RBNode* DictionaryIndex::rightRotateRB(RBNode* root, RBNode* node) {
+    RBNode* leftChild = node->left;
+    node->left = leftChild->right;
+    if (leftChild->right != nullptr) {
+        leftChild->right->parent = node;
+    }
+    leftChild->parent = node->parent;
+    if (node->parent == nullptr) {
+        root = leftChild; // 如果旋转的是根节点，更新根节点
+    } else if (node == node->parent->right) {
+        node->parent->right = leftChild;
+    } else {
+        node->parent->left = leftChild;
+    }
+    leftChild->right = node;
+    node->parent = leftChild;
+
+    return root;
+}
+
+
+template <typename Path>
+bool DictionaryIndex::sequentialSearch(string_view key, Path& path, string_view& result) const {
+    for (const auto& wordPair : m_allWords) {
+        path.visit(wordPair.first);
+        if (wordPair.first == key) {
+            result = wordPair.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Path>
+bool DictionaryIndex::searchSorted(string_view key, Path& path, string_view& result) const {
+    size_t low = 0;
+    size_t high = m_allWords.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        path.visit(m_allWords[mid].first);
+        if (m_allWords[mid].first < key) low = mid + 1;
+        else high = mid;
+    }
+    if (low == m_allWords.size()) return false;
+    path.compare(m_allWords[low].first);
+    if (m_allWords[low].first != key) return false;
+    result = m_allWords[low].second;
+    return true;
+}
+
+// 三种树的查找相同，只是节点类型不同
+template <typename Node, typename Path>
+static bool searchTree(Node* root, string_view key, Path& path, string_view& result) {
+    while (root) {
+        path.visit(root->key);
+        int comparison = compareBytes(key, root->key);
+        if (comparison == 0) {
+            result = root->value;
+            return true;
+        }
+        root = comparison < 0 ? root->left : root->right;
+    }
+    return false;
+}
+
+//search函数
+template <typename Path>
+bool DictionaryIndex::searchBST(BSTNode* root, string_view key, Path& path, string_view& result) const {
+    return searchTree(root, key, path, result);
+}
+
+template <typename Path>
+bool DictionaryIndex::searchAVL(AVLNode* root, string_view key, Path& path, string_view& result) const {
+    return searchTree(root, key, path, result);
+}
+
+// 搜索 RB 函数实现
+template <typename Path>
+bool DictionaryIndex::searchRB(RBNode* root, string_view key, Path& path, string_view& result) const {
+    return searchTree(root, key, path, result);
+}
+
+template <typename Path>
+bool DictionaryIndex::searchEytzinger(string_view key, Path& path, string_view& result) const {
+    return m_eytzinger.search(key, path, result);
+}
+
+template <typename Path>
+bool DictionaryIndex::search(Engine engine, string_view key, Path& path, string_view& result) const {
+    char firstChar = shardOf(key);
+    switch (engine) {
+    case Engine::Sequential: return sequentialSearch(key, path, result);
+    case Engine::SortedArray: return searchSorted(key, path, result);
+    case Engine::BST: return searchBST(bstRoot(firstChar), key, path, result);
+    case Engine::AVL: return searchAVL(avlRoot(firstChar), key, path, result);
+    case Engine::RB: return searchRB(rbRoot(firstChar), key, path, result);
+    case Engine::Eytzinger: return searchEytzinger(key, path, result);
+    // 联想、纠错、汉译英和后缀引擎不做精确查找
+    case Engine::Trie:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return false;
+}
+
+// 查找只对这三种访问者实例化
+#define DICT_INSTANTIATE_SEARCH(Path)                                                                          \
+    template bool DictionaryIndex::sequentialSearch(string_view, Path&, string_view&) const;                  \
+    template bool DictionaryIndex::searchSorted(string_view, Path&, string_view&) const;                      \
+    template bool DictionaryIndex::searchBST(BSTNode*, string_view, Path&, string_view&) const;               \
+    template bool DictionaryIndex::searchAVL(AVLNode*, string_view, Path&, string_view&) const;               \
+    template bool DictionaryIndex::searchRB(RBNode*, string_view, Path&, string_view&) const;                 \
+    template bool DictionaryIndex::searchEytzinger(string_view, Path&, string_view&) const;                   \
+    template bool DictionaryIndex::search(Engine, string_view, Path&, string_view&) const;
+DICT_INSTANTIATE_SEARCH(NoPath)
+DICT_INSTANTIATE_SEARCH(PathRecorder)
+DICT_INSTANTIATE_SEARCH(QueryProbe)
+#undef DICT_INSTANTIATE_SEARCH
+
+vector<string> DictionaryIndex::suggestCorrections(const string& word, int maxDistance, int maxResults) const {
+    vector<FuzzyMatch> matches = isReady(Engine::Fuzzy) ? m_symSpell.search(word, maxDistance)
+                                                        : m_trie.fuzzySearch(word, maxDistance);
+    auto frequency = [&](uint32_t entry) { return m_frequency.empty() ? 0 : m_frequency[entry]; };
+    stable_sort(matches.begin(), matches.end(), [&](const FuzzyMatch& a, const FuzzyMatch& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return frequency(a.entry) > frequency(b.entry);
+    });
+    vector<string> results;
+    for (const FuzzyMatch& match : matches) {
+        if ((int)results.size() >= maxResults) break;
+        results.emplace_back(m_allWords[match.entry].first);
+    }
+    return results;
+}
+
+size_t DictionaryIndex::patternSearch(const string& pattern, const function<bool(string_view word)>& onMatch,
+                                      const function<bool()>& shouldStop) const {
+    WildcardPattern compiled(pattern);
+    if (!compiled.isValid()) return 0;
+    size_t found = 0;
+    bool stopped = false;
+    auto deliver = [&](uint32_t entry) {
+        ++found;
+        stopped = !onMatch(m_allWords[entry].first);
+        return !stopped;
+    };
+    size_t visited = 0;
+    auto interrupted = [&]() {
+        stopped = stopped || (shouldStop && ++visited % WildcardPattern::kStopInterval == 0 && shouldStop());
+        return stopped;
+    };
+    string_view suffix = compiled.trailingLiteral();
+    if (compiled.leadingStar() && !suffix.empty() && isReady(Engine::Suffix)) {
+        m_reversedKeys.forEachWithSuffix(suffix, [&](uint32_t entry) {
+            if (interrupted()) return false;
+            return !compiled.matches(m_allWords[entry].first) || deliver(entry);
+        });
+    } else if (isReady(Engine::Trie)) {
+        m_trie.patternSearch(compiled, deliver, shouldStop);
+    } else {
+        for (size_t i = 0; i < m_allWords.size() && !interrupted(); ++i) {
+            if (i > 0 && m_allWords[i].first == m_allWords[i - 1].first) continue;
+            if (compiled.matches(m_allWords[i].first)) deliver(static_cast<uint32_t>(i));
+        }
+    }
+    return found;
+}
+
+vector<pair<string, string>> DictionaryIndex::reverseLookup(const string& meaning, int maxResults) const {
+    vector<pair<string, string>> results;
+    for (uint32_t entry : m_reverse.search(meaning, maxResults)) {
+        results.emplace_back(m_allWords[entry].first, m_allWords[entry].second);
+    }
+    return results;
+}
+
+// 按无符号字节比较，与有序建树和快照使用的 std::string 顺序一致
+int DictionaryIndex::compareKeys(string_view a, string_view b) {
+    return compareBytes(a, b);
+}
+
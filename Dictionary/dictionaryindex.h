@@ -0,0 +1,257 @@
+#ifndef DICTIONARYINDEX_H
+#define DICTIONARYINDEX_H
+
+#include "csvreader.h"
+#include "eytzingerindex.h"
+#include "fuzzysearch.h"
+#include "normalizedindex.h"
+#include "nodearena.h"
+#include "patternsearch.h"
+#include "radixtrie.h"
+#include "reverseindex.h"
+#include "searchpath.h"
+#include "stringpool.h"
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 树节点的 key/value 指向 DictionaryIndex 的字符串池，节点本身不持有字符串
+
+// 二叉搜索树节点
+struct BSTNode {
+    string_view key;
+    string_view value;
+    BSTNode* left;
+    BSTNode* right;
+    BSTNode(string_view k, string_view v) : key(k), value(v), left(nullptr), right(nullptr) {}
+};
+
+
+// AVL树节点
+struct AVLNode {
+    string_view key;
+    string_view value;
+    AVLNode* left;
+    AVLNode* right;
+    int height; // 平衡因子
+
+    AVLNode(string_view k, string_view v) : key(k), value(v), left(nullptr), right(nullptr), height(1) {}
+};
+
+// 红黑树节点
+struct RBNode {
+    string_view key;
+    string_view value;
+    RBNode* left;
+    RBNode* right;
+    RBNode* parent;
+    bool isRed; // 红黑标志
+    RBNode(string_view k, string_view v) : key(k), value(v), left(nullptr), right(nullptr), parent(nullptr), isRed(true) {}
+};
+
+// 节点可平凡析构，分配器释放时只需归还内存块
+static_assert(is_trivially_destructible_v<BSTNode> && is_trivially_destructible_v<AVLNode>
+              && is_trivially_destructible_v<RBNode>, "tree nodes must not own memory");
+
+// 一个引擎单独使用时占用的内存（字节）。单词和释义只在共用的字符串池中存一份，
+// 引擎里只有视图，所以引用的字符串不计入合计，另外给出假如每条各存一份 std::string 时的情况
+struct EngineMemory {
+    size_t structureBytes = 0;    // 节点或表项本身，含其中的 string_view
+    size_t viewBytes = 0;         // 其中 string_view 的字节
+    size_t allocatorOverhead = 0; // 块中未用的槽、vector 多余的容量、每次堆分配的头部和对齐
+    size_t shardMapBytes = 0;     // 首字母分片 map 的节点
+    size_t allocations = 0;       // 向堆申请的次数
+    size_t referencedStringBytes = 0; // 引用的单词和释义的字节
+    size_t inlineStrings = 0;     // 存成 std::string 时不超过 15 字节、放在对象内部的个数
+    size_t heapStrings = 0;       // 存成 std::string 时要另外申请堆内存的个数
+    size_t heapStringBytes = 0;   // 这些堆块的字节，含分配头
+    size_t total() const { return structureBytes + allocatorOverhead + shardMapBytes; }
+};
+
+// 查找引擎，按建立完成的先后排列；基数树只用于输入联想，Fuzzy 只用于查不到时的拼写纠正，
+// Reverse 只用于按中文释义反查英文单词，Suffix 只用于以 * 开头的通配符查找
+enum class Engine { Sequential, SortedArray, Trie, BST, AVL, RB, Eytzinger, Fuzzy, Reverse, Suffix };
+const char* engineName(Engine engine);
+
+// 字典的全部索引。加载线程逐个建立引擎并调用 markReady 发布，
+// 界面线程只查询 isReady 为真的引擎；发布之后该引擎不再被修改
+class DictionaryIndex {
+public:
+    // 串行建树保留用于对比；并行模式在线程池上按首字母分片建树
+    enum class BuildMode { Serial, Parallel };
+    // Sorted：分片已按单词排序，直接建出完全平衡的树（线性时间）；
+    // Insertion：按文件顺序逐个插入，字典本身有序时 BST 会退化成链表，保留用于演示和对比
+    enum class BuildOrder { Sorted, Insertion };
+
+    DictionaryIndex() = default;
+    ~DictionaryIndex() = default; // 节点随各引擎的分配器整体释放
+    DictionaryIndex(const DictionaryIndex&) = delete;
+    DictionaryIndex& operator=(const DictionaryIndex&) = delete;
+
+    bool isReady(Engine engine) const;
+    void markReady(Engine engine);
+
+    // 以下建立接口只由加载线程调用
+    StringPool& strings() { return m_strings; }
+    const StringPool& strings() const { return m_strings; }
+    // words 必须指向 strings() 中的字符串；按单词稳定排序后作为顺序查找表，
+    // 同一单词的多条释义保持文件中的先后
+    void setWords(vector<pair<string_view, string_view>> words);
+    static void sortByWord(vector<DictRecord>& records);
+    static map<char, vector<size_t>> partitionByFirstChar(const vector<DictRecord>& records);
+    // 单词所在分片的键：首字节转成小写，空串为 0。tolower 只接受 unsigned char 范围的值，
+    // UTF-8 的首字节按 char 传入是负数，须先转换
+    static char shardOf(string_view word) {
+        return word.empty() ? 0 : char(tolower(static_cast<unsigned char>(word[0])));
+    }
+    // 每片的建法只取决于片内记录的顺序，所以并行和串行建出的树完全相同。
+    // Sorted 要求 records 已经过 sortByWord；两种顺序建出的树内容相同：
+    // 重复单词在 BST/AVL 中保留第一条释义，在红黑树中保留最后一条
+    void buildEngine(Engine engine, const vector<DictRecord>& records,
+                     const map<char, vector<size_t>>& shards, BuildMode mode, BuildOrder order,
+                     const function<void()>& shardDone = nullptr);
+
+    // 规范化键索引，在发布顺序查找表之前建立，之后随顺序查找表一起可用
+    void buildNormalizedKeys() { m_normalized.build(m_allWords); }
+    const NormalizedIndex& normalizedKeys() const { return m_normalized; }
+    // 不论大小写和首尾的空白、标点，找到 query 对应的词表中的写法；各引擎都按这个写法查找。
+    // query 原样在词表中时就用它本身，否则换成规范键对应的写法，两者都由规范化索引一次查出
+    bool canonicalWord(const string& query, string& word) const;
+
+    // 词频按单词给出，同一单词的多条释义算一个词；返回词表中找到的单词数。
+    // 须在建立基数树之前设置，基数树据此为每个前缀预先排好候选词
+    size_t setFrequencies(const vector<pair<string_view, uint64_t>>& counts);
+    bool hasFrequencies() const { return !m_frequency.empty(); }
+    size_t rankingBytes() const { return m_trie.rankingBytes() + m_frequency.capacity() * sizeof(uint64_t); }
+
+    // 基数树、Eytzinger 布局、近似查找的删除索引、释义的倒排索引和反转键索引都由有序词表直接建出
+    void buildStaticEngine(Engine engine);
+
+    size_t wordCount() const { return m_allWords.size(); }
+    pair<string_view, string_view> wordAt(size_t i) const { return m_allWords[i]; }
+    size_t shardCount() const { return bstMap.size(); }
+    // 三种树的分片相同，按首字母排列；二叉树最先建立，它就绪后即可调用
+    vector<char> shardKeys() const;
+    ArenaStats nodeStats(Engine engine) const;
+    // 三种树和顺序表逐项统计，含字符串的明细；二分查找与顺序查找共用词表，给出的是同一份。
+    // 基数树等静态引擎只有结构的字节（按容量计）。遍历整个引擎，只用于诊断和基准
+    EngineMemory memoryUsage(Engine engine) const;
+
+    // 各首字母分片的根，不存在时返回 nullptr
+    BSTNode* bstRoot(char firstChar) const;
+    AVLNode* avlRoot(char firstChar) const;
+    RBNode* rbRoot(char firstChar) const;
+
+    vector<string> prefixSearchSequential(const string& prefix, int maxResults = 10) const; //按序查找
+    // 有序词表上二分出前缀区间，结果去重；nodesVisited 为二分的探测次数
+    vector<string> prefixSearchSorted(const string& prefix, int maxResults = 10, size_t* nodesVisited = nullptr) const;
+    // 树上的联想按字母序返回；nodesVisited 非空时写入本次访问的节点数
+    vector<string> prefixSearchBST(BSTNode* root, const std::string& prefix, int maxResults = 10,
+                                   size_t* nodesVisited = nullptr) const;
+    vector<string> prefixSearchAVL(AVLNode* root, const string& prefix, int maxResults = 10,
+                                   size_t* nodesVisited = nullptr) const;
+    vector<string> prefixSearchRB(RBNode* root, const string& prefix, int maxResults = 10,
+                                  size_t* nodesVisited = nullptr) const;
+    vector<string> prefixSearchTrie(const string& prefix, int maxResults = 10) const;
+    // 增量联想：输入在上一个前缀之后追加字符时，把游标向下移动新增的部分即可
+    using TrieCursor = RadixTrie::Cursor;
+    bool narrowTrie(TrieCursor& cursor, string_view added) const { return m_trie.advance(cursor, added); }
+    vector<string> trieCompletions(const TrieCursor& cursor, int maxResults = 10) const {
+        return m_trie.completions(cursor, maxResults);
+    }
+    size_t staticEngineBytes(Engine engine) const;
+
+    // 精确查找。Path 为 NoPath、PathRecorder 或 QueryProbe（见 searchpath.h），只对这三种实例化；
+    // result 指向字符串池中的释义
+    template <typename Path>
+    bool searchBST(BSTNode* root, string_view key, Path& path, string_view& result) const;
+    template <typename Path>
+    bool sequentialSearch(string_view key, Path& path, string_view& result) const;
+    // 二分查找，path 记录每次探测的中点；同一单词有多条释义时取第一条，与顺序查找一致
+    template <typename Path>
+    bool searchSorted(string_view key, Path& path, string_view& result) const;
+    template <typename Path>
+    bool searchAVL(AVLNode* root, string_view key, Path& path, string_view& result) const;
+    template <typename Path>
+    bool searchRB(RBNode* root, string_view key, Path& path, string_view& result) const;
+    template <typename Path>
+    bool searchEytzinger(string_view key, Path& path, string_view& result) const;
+    // 按引擎分派到上面的函数，树引擎按首字母（小写）取分片；其他引擎返回 false
+    template <typename Path>
+    bool search(Engine engine, string_view key, Path& path, string_view& result) const;
+
+    // 查不到时的“您是不是要找”：编辑距离不超过 maxDistance 的单词，按距离、词频、字典序排列。
+    // 删除索引就绪后用它，之前在基数树上剪枝计算，需基数树已就绪
+    vector<string> suggestCorrections(const string& word, int maxDistance = kMaxCorrectionDistance,
+                                      int maxResults = 5) const;
+    vector<FuzzyMatch> fuzzySearchTrie(string_view word, int maxDistance) const {
+        return m_trie.fuzzySearch(word, maxDistance);
+    }
+    vector<FuzzyMatch> fuzzySearchSymSpell(string_view word, int maxDistance) const {
+        return m_symSpell.search(word, maxDistance);
+    }
+    static const int kMaxCorrectionDistance = 2;
+
+    // 通配符查找：依次给出匹配 pattern 的单词，onMatch 返回 false 时停止；返回给出的个数。
+    // 以 * 开头且以字面后缀结尾的模式在反转键索引上按后缀取候选，其余的在基数树上剪枝遍历，
+    // 相应的引擎未就绪时扫描有序词表。模式超过 WildcardPattern::kMaxLength 时没有结果。
+    // shouldStop 非空时每访问 WildcardPattern::kStopInterval 个节点、候选或词条调用一次，返回 true 时停止；
+    // 匹配很少的模式也要走完整棵树，只靠 onMatch 无法按时限或新的输入取消
+    size_t patternSearch(const string& pattern, const function<bool(string_view word)>& onMatch,
+                         const function<bool()>& shouldStop = {}) const;
+
+    // 汉译英：释义中含有 meaning 的词条（单词，释义），释义短的在前；需释义索引已就绪
+    vector<pair<string, string>> reverseLookup(const string& meaning, int maxResults = 10) const;
+    const ReverseIndex& reverseIndex() const { return m_reverse; }
+
+private:
+    friend class DictionarySnapshot;
+
+    // 数据存储
+    StringPool m_strings; // 所有单词和释义的唯一一份
+    vector<pair<string_view, string_view>> m_allWords; // 顺序查找和二分查找，按单词有序
+    map<char, BSTNode*> bstMap; // 依照首字母建立二叉树
+    map<char, AVLNode*> avlMap;  // AVL 树
+    map<char, RBNode*> rbMap; // 红黑树
+    RadixTrie m_trie; // 输入联想
+    vector<uint64_t> m_frequency; // 按词表下标，没有词频文件时为空
+    EytzingerIndex m_eytzinger; // 缓存友好的静态布局
+    SymSpellIndex m_symSpell; // 拼写纠正
+    NormalizedIndex m_normalized; // 不区分大小写的查询
+    ReverseIndex m_reverse; // 汉译英
+    ReversedKeyIndex m_reversedKeys; // 后缀查找
+    // 各引擎的节点都从自己的分配器中切出
+    NodeArena<BSTNode> m_bstArena;
+    NodeArena<AVLNode> m_avlArena;
+    NodeArena<RBNode> m_rbArena;
+    atomic<unsigned> m_readyMask{0};
+
+    static const int kRankedCompletions = 10; // 每个前缀预先排好的候选词个数，与联想列表的长度一致
+
+    static BSTNode* insertBST(NodeArena<BSTNode>& arena, BSTNode* root, string_view key, string_view value);
+    static AVLNode* insertAVL(NodeArena<AVLNode>& arena, AVLNode* root, string_view key, string_view value);
+    static RBNode* insertRB(NodeArena<RBNode>& arena, RBNode* root, string_view key, string_view value);
+
+    // 由有序、无重复的区间 [begin, end) 直接建平衡树
+    static BSTNode* buildBalancedBST(NodeArena<BSTNode>& arena, const DictRecord* begin, const DictRecord* end);
+    static AVLNode* buildBalancedAVL(NodeArena<AVLNode>& arena, const DictRecord* begin, const DictRecord* end);
+    static RBNode* buildBalancedRB(NodeArena<RBNode>& arena, const DictRecord* begin, const DictRecord* end,
+                                   int depth, int redDepth);
+
+    static int compareKeys(string_view a, string_view b);
+    // AVL 树的旋转
+    static AVLNode* rotateLeft(AVLNode* x);
+    static AVLNode* rotateRight(AVLNode* y);
+    static int getHeight(AVLNode* node);
+    static int getBalance(AVLNode* node);
+    static RBNode* fixInsertRB(RBNode* root, RBNode* node);
+    static RBNode* leftRotateRB(RBNode* root, RBNode* node);
+    static RBNode* rightRotateRB(RBNode* root, RBNode* node);
+};
+
+#endif
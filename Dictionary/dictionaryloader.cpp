@@ -0,0 +1,294 @@
+#include "dictionaryloader.h"
+#include "dictionarysnapshot.h"
+#include "benchmark.h"
+#include "mappedfile.h"
+#include "memoryusage.h"
+#include <QByteArray>
+#include <QDebug>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+
+DictionaryLoader::DictionaryLoader(shared_ptr<DictionaryIndex> index, QObject* parent)
+    : QObject(parent), m_index(std::move(index)) {}
+
+static bool interrupted() {
+    return QThread::currentThread()->isInterruptionRequested();
+}
+
+// 分块分配与逐个 new 的对比。逐个 new 按常见 malloc 的实现估算：
+// 每次分配带 8 字节头并按 16 字节对齐
+template<typename NodeT>
+static void logNodeStats(const DictionaryIndex& index, Engine engine) {
+    ArenaStats stats = index.nodeStats(engine);
+    size_t heapBytes = stats.nodes * ((sizeof(NodeT) + 8 + 15) & ~size_t(15));
+    qInfo().noquote() << QString("%1节点 %2 个（%3 字节/个）：实际分配 %4 次共 %5 KB；逐个 new 需 %6 次约 %7 KB")
+                             .arg(engineName(engine))
+                             .arg(stats.nodes)
+                             .arg(sizeof(NodeT))
+                             .arg(stats.allocations)
+                             .arg(stats.bytes / 1024)
+                             .arg(stats.nodes)
+                             .arg(heapBytes / 1024);
+}
+
+static void logNodeStats(const DictionaryIndex& index) {
+    logNodeStats<BSTNode>(index, Engine::BST);
+    logNodeStats<AVLNode>(index, Engine::AVL);
+    logNodeStats<RBNode>(index, Engine::RB);
+}
+
+// 字符串池与每个引擎各存一份 std::string（顺序表 + 三棵树）时的对比
+static void logStringStats(const DictionaryIndex& index) {
+    const StringPool& pool = index.strings();
+    size_t textBytes = 0, copiedBytes = 0;
+    for (size_t i = 0; i < index.wordCount(); ++i) {
+        auto [word, meaning] = index.wordAt(i);
+        textBytes += word.size() + meaning.size();
+        // 超出短字符串优化（15 字节）的部分另占一块堆内存
+        for (string_view text : {word, meaning}) {
+            copiedBytes += sizeof(string);
+            if (text.size() > 15) copiedBytes += (text.size() + 1 + 8 + 15) & ~size_t(15);
+        }
+    }
+    // 映射的快照里还有节点表，这里只按字符串本身计
+    size_t pooledBytes = textBytes + index.wordCount() * 2 * sizeof(string_view) * 4;
+    qInfo().noquote() << QString("字符串 %1 KB：池中 %2 KB（拷贝）+ %3 KB（映射），连同 4 个引擎的视图共 %4 KB；"
+                                 "每个引擎各存一份 std::string 约 %5 KB；峰值常驻内存 %6 MB")
+                             .arg(textBytes / 1024)
+                             .arg(pool.ownedBytes() / 1024)
+                             .arg(pool.mappedBytes() / 1024)
+                             .arg(pooledBytes / 1024)
+                             .arg(copiedBytes * 4 / 1024)
+                             .arg(peakResidentBytes() / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void DictionaryLoader::load(const QString& fileName) {
+    emit progress(0, "读取字典文件");
+    qInfo().noquote() << QString("加载前峰值常驻内存 %1 MB").arg(peakResidentBytes() / (1024.0 * 1024.0), 0, 'f', 1);
+    SourceStamp stamp;
+    if (!DictionarySnapshot::stampOf(fileName, stamp)) {
+        emit failed("无法打开字典文件！");
+        return;
+    }
+
+    // 逐个插入只用于演示退化的 BST，不读写快照
+    auto order = qEnvironmentVariable("DICT_BUILD_ORDER") == "insertion" ? DictionaryIndex::BuildOrder::Insertion
+                                                                        : DictionaryIndex::BuildOrder::Sorted;
+
+    // 快照与 CSV 的大小、修改时间一致时直接使用，否则重新解析并覆盖快照
+    bool useSnapshot = m_snapshotsEnabled && !qEnvironmentVariableIsSet("DICT_NO_SNAPSHOT")
+                       && order == DictionaryIndex::BuildOrder::Sorted;
+    QString snapshotPath = DictionarySnapshot::pathFor(fileName);
+    m_frequencyPath = qEnvironmentVariableIsSet("DICT_FREQ_FILE") ? qEnvironmentVariable("DICT_FREQ_FILE")
+                                                                  : fileName + ".freq";
+    bool fromSnapshot = useSnapshot && loadSnapshot(snapshotPath, stamp);
+    if (interrupted()) return;
+    if (!fromSnapshot) {
+        if (!loadCsv(fileName, order) || interrupted()) return;
+
+        if (useSnapshot) {
+            auto saveStart = chrono::steady_clock::now();
+            if (DictionarySnapshot::save(*m_index, snapshotPath, stamp)) {
+                auto saveEnd = chrono::steady_clock::now();
+                qInfo().noquote() << QString("索引快照已写入 %1，用时 %2 ms")
+                                         .arg(snapshotPath)
+                                         .arg(chrono::duration<double, milli>(saveEnd - saveStart).count(), 0, 'f', 1);
+            } else {
+                qWarning() << "无法写入索引快照:" << snapshotPath;
+            }
+            if (interrupted()) return;
+        }
+    }
+
+    // 静态布局、删除索引、释义索引和反转键索引不进快照，由有序词表建出
+    vector<Engine> staticEngines = {Engine::Eytzinger};
+    if (m_auxiliaryEngines) staticEngines.insert(staticEngines.end(), {Engine::Fuzzy, Engine::Reverse, Engine::Suffix});
+    for (Engine engine : staticEngines) {
+        if (interrupted()) return;
+        buildStaticEngine(engine);
+    }
+    emit progress(100, fromSnapshot ? "已从快照载入索引" : "索引建立完成");
+
+    if (interrupted()) return;
+    if (qEnvironmentVariableIsSet("DICT_BENCH")) {
+        runLookupBenchmark(*m_index);
+        runPrefixBenchmark(*m_index);
+        runFuzzyBenchmark(*m_index);
+        runKernelBenchmark();
+    }
+    emit finished();
+}
+
+bool DictionaryLoader::loadSnapshot(const QString& snapshotPath, const SourceStamp& stamp) {
+    auto start = chrono::steady_clock::now();
+    if (!DictionarySnapshot::load(*m_index, snapshotPath, stamp)) return false;
+    auto end = chrono::steady_clock::now();
+    qInfo().noquote() << QString("从索引快照载入 %1 条记录，用时 %2 ms")
+                             .arg(m_index->wordCount())
+                             .arg(chrono::duration<double, milli>(end - start).count(), 0, 'f', 1);
+    logNodeStats(*m_index);
+    logStringStats(*m_index);
+
+    buildNormalizedKeys();
+    for (Engine engine : {Engine::Sequential, Engine::SortedArray, Engine::BST, Engine::AVL, Engine::RB}) {
+        m_index->markReady(engine);
+        emit engineReady(static_cast<int>(engine));
+    }
+    // 快照已经载入，中断时不回退到 CSV，由 load 检查后返回
+    if (interrupted()) return true;
+    // 基数树不进快照，由快照中的有序词表线性建出
+    loadFrequencies();
+    buildStaticEngine(Engine::Trie);
+    return true;
+}
+
+void DictionaryLoader::buildNormalizedKeys() {
+    auto start = chrono::steady_clock::now();
+    m_index->buildNormalizedKeys();
+    auto end = chrono::steady_clock::now();
+    const NormalizedIndex& keys = m_index->normalizedKeys();
+    qInfo().noquote() << QString("规范化键 %1 个（%2 个词条合并，%3 个键与原词不同），用时 %4 ms，占用 %5 KB")
+                             .arg(keys.size())
+                             .arg(m_index->wordCount() - keys.size())
+                             .arg(keys.rewrittenCount())
+                             .arg(chrono::duration<double, milli>(end - start).count(), 0, 'f', 1)
+                             .arg(keys.memoryBytes() / 1024);
+}
+
+// 词频文件可选，不存在时联想按字典序。文件与字典同格式，第二列是出现次数
+void DictionaryLoader::loadFrequencies() {
+    MappedFile file;
+    if (!file.open(m_frequencyPath)) return;
+    auto start = chrono::steady_clock::now();
+    vector<DictRecord> records;
+    vector<string_view> malformed;
+    parseDictionaryCsv(file.data(), file.size(), records, malformed);
+
+    vector<pair<string_view, uint64_t>> counts;
+    counts.reserve(records.size());
+    for (const DictRecord& record : records) {
+        bool ok = false;
+        uint64_t count = QByteArray(record.meaning.data(), int(record.meaning.size())).toULongLong(&ok);
+        if (ok) counts.emplace_back(record.word, count);
+        else malformed.push_back(record.word);
+    }
+    size_t matched = m_index->setFrequencies(counts);
+    auto end = chrono::steady_clock::now();
+    qInfo().noquote() << QString("词频 %1 条，匹配 %2 个单词，%3 行无法解析，用时 %4 ms")
+                             .arg(counts.size())
+                             .arg(matched)
+                             .arg(malformed.size())
+                             .arg(chrono::duration<double, milli>(end - start).count(), 0, 'f', 1);
+}
+
+void DictionaryLoader::buildStaticEngine(Engine engine) {
+    auto start = chrono::steady_clock::now();
+    m_index->buildStaticEngine(engine);
+    auto end = chrono::steady_clock::now();
+    m_index->markReady(engine);
+    emit engineReady(static_cast<int>(engine));
+
+    ArenaStats bst = m_index->nodeStats(Engine::BST);
+    qInfo().noquote() << QString("建立%1用时 %2 ms，占用 %3 KB")
+                             .arg(engineName(engine))
+                             .arg(chrono::duration<double, milli>(end - start).count(), 0, 'f', 1)
+                             .arg(m_index->staticEngineBytes(engine) / 1024)
+                      << (engine == Engine::Trie && m_index->hasFrequencies()
+                              ? QString("（含词频排序 %1 KB）").arg(m_index->rankingBytes() / 1024)
+                              : QString())
+                      << (bst.nodes ? QString("（二叉树节点 %1 KB）").arg(bst.bytes / 1024) : QString());
+    if (engine == Engine::Reverse) {
+        const ReverseIndex& reverse = m_index->reverseIndex();
+        qInfo().noquote() << QString("释义索引 %1 个单字和二元组，%2 条倒排记录，倒排表 %3 KB（压缩前 %4 KB）")
+                                 .arg(reverse.termCount())
+                                 .arg(reverse.postingCount())
+                                 .arg(reverse.postingBytes() / 1024)
+                                 .arg(reverse.uncompressedBytes() / 1024);
+    }
+}
+
+bool DictionaryLoader::loadCsv(const QString& fileName, DictionaryIndex::BuildOrder order) {
+    MappedFile file;
+    if (!file.open(fileName)) {
+        emit failed("无法打开字典文件！");
+        return false;
+    }
+
+    // 直接在映射内存上解析，记录只是指向文件字节的视图
+    vector<DictRecord> records;
+    vector<string_view> malformed;
+    auto parseStart = chrono::steady_clock::now();
+    parseDictionaryCsv(file.data(), file.size(), records, malformed);
+    auto parseEnd = chrono::steady_clock::now();
+
+    for (string_view line : malformed) {
+        qWarning() << "信息缺失行:" << QString::fromUtf8(line.data(), line.size());
+    }
+    double seconds = chrono::duration<double>(parseEnd - parseStart).count();
+    double megabytes = file.size() / (1024.0 * 1024.0);
+    qInfo().noquote() << QString("解析 %1 MB，%2 条记录，用时 %3 ms，吞吐 %4 MB/s")
+                             .arg(megabytes, 0, 'f', 2)
+                             .arg(records.size())
+                             .arg(seconds * 1000.0, 0, 'f', 2)
+                             .arg(seconds > 0 ? megabytes / seconds : 0.0, 0, 'f', 1);
+
+    // 单词和释义各拷贝一次进字符串池，之后 CSV 映射即可释放，各引擎都引用池中的这一份
+    size_t textBytes = 0;
+    for (const DictRecord& record : records) textBytes += record.word.size() + record.meaning.size();
+    StringPool& pool = m_index->strings();
+    pool.reserve(textBytes);
+    for (DictRecord& record : records) {
+        record.word = pool.add(record.word);
+        record.meaning = pool.add(record.meaning);
+    }
+    file.close();
+
+    // 有序建树时记录先按单词排好，顺序表和每个分片都直接取有序区间
+    if (order == DictionaryIndex::BuildOrder::Sorted) DictionaryIndex::sortByWord(records);
+
+    // 顺序查找表最先可用，它已按单词排好序，二分查找同时可用
+    vector<pair<string_view, string_view>> words;
+    words.reserve(records.size());
+    for (const DictRecord& record : records) words.emplace_back(record.word, record.meaning);
+    m_index->setWords(std::move(words));
+    buildNormalizedKeys();
+    for (Engine engine : {Engine::Sequential, Engine::SortedArray}) {
+        m_index->markReady(engine);
+        emit engineReady(static_cast<int>(engine));
+    }
+
+    // 基数树只依赖有序词表，建得很快，先于三棵树发布供输入联想使用
+    loadFrequencies();
+    buildStaticEngine(Engine::Trie);
+    emit progress(10, "建立索引");
+
+    auto mode = qEnvironmentVariable("DICT_BUILD_MODE") == "serial" ? DictionaryIndex::BuildMode::Serial
+                                                                    : DictionaryIndex::BuildMode::Parallel;
+    auto shards = DictionaryIndex::partitionByFirstChar(records);
+    const Engine trees[] = {Engine::BST, Engine::AVL, Engine::RB};
+    const int totalShards = static_cast<int>(shards.size() * size(trees));
+    atomic<int> doneShards{0};
+
+    for (Engine engine : trees) {
+        if (interrupted()) return false;
+        QString stage = QString("建立%1索引").arg(engineName(engine));
+        auto buildStart = chrono::steady_clock::now();
+        m_index->buildEngine(engine, records, shards, mode, order, [&]() {
+            int done = ++doneShards;
+            emit progress(10 + 90 * done / totalShards, stage);
+        });
+        auto buildEnd = chrono::steady_clock::now();
+        m_index->markReady(engine);
+        emit engineReady(static_cast<int>(engine));
+        qInfo().noquote() << QString("%1%2%3用时 %4 ms（%5 个首字母分片）")
+                                 .arg(mode == DictionaryIndex::BuildMode::Serial ? "串行" : "并行")
+                                 .arg(order == DictionaryIndex::BuildOrder::Sorted ? "有序" : "逐个插入")
+                                 .arg(stage)
+                                 .arg(chrono::duration<double, milli>(buildEnd - buildStart).count(), 0, 'f', 1)
+                                 .arg(shards.size());
+    }
+    logNodeStats(*m_index);
+    logStringStats(*m_index);
+    return true;
+}
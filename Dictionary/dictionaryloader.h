@@ -0,0 +1,48 @@
+#ifndef DICTIONARYLOADER_H
+#define DICTIONARYLOADER_H
+
+#include "dictionaryindex.h"
+#include <QObject>
+#include <QString>
+#include <memory>
+
+struct SourceStamp;
+
+// 在后台线程中读取字典并逐个建立引擎。
+// 每个引擎建好后立即发布到 index 并发出 engineReady，界面可以马上使用。
+// 有匹配的索引快照时直接载入快照，否则解析 CSV 后写出快照供下次启动使用。
+// 字典旁若有同名的 .freq 文件（"word","count" 格式，可用 DICT_FREQ_FILE 指定），联想按词频排序
+class DictionaryLoader : public QObject {
+    Q_OBJECT
+public:
+    DictionaryLoader(shared_ptr<DictionaryIndex> index, QObject* parent = nullptr);
+
+    // 以下在 load 之前设置。不读写索引快照（与 DICT_NO_SNAPSHOT 相同），用于只加载一次的字典
+    void setSnapshotsEnabled(bool enabled) { m_snapshotsEnabled = enabled; }
+    // 只建查找和联想用的引擎，跳过拼写纠正的删除索引、释义索引和后缀索引；
+    // 千万条的词表上删除索引要占几 GB，规模测试时关掉
+    void setAuxiliaryEnginesEnabled(bool enabled) { m_auxiliaryEngines = enabled; }
+
+public slots:
+    void load(const QString& fileName);
+
+signals:
+    void progress(int percent, const QString& stage);
+    void engineReady(int engine); // Engine 的整数值
+    void failed(const QString& message);
+    void finished();
+
+private:
+    bool loadSnapshot(const QString& snapshotPath, const SourceStamp& stamp);
+    bool loadCsv(const QString& fileName, DictionaryIndex::BuildOrder order);
+    void buildStaticEngine(Engine engine);
+    void loadFrequencies();
+    void buildNormalizedKeys();
+
+    shared_ptr<DictionaryIndex> m_index;
+    QString m_frequencyPath;
+    bool m_snapshotsEnabled = true;
+    bool m_auxiliaryEngines = true;
+};
+
+#endif
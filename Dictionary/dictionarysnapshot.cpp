@@ -0,0 +1,280 @@
+#include "dictionarysnapshot.h"
+#include "mappedfile.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace snapshot;
+
+QString DictionarySnapshot::pathFor(const QString& csvFileName) {
+    return csvFileName + ".idx";
+}
+
+bool DictionarySnapshot::stampOf(const QString& fileName, SourceStamp& stamp) {
+    QFileInfo info(fileName);
+    if (!info.exists()) return false;
+    stamp.size = static_cast<uint64_t>(info.size());
+    stamp.mtime = info.lastModified().toMSecsSinceEpoch();
+    return true;
+}
+
+// 节点对应的词条下标：m_allWords 按单词排好序，二分找到同一单词的区间后再比释义。
+// 找不到时返回词条数，写出的快照在载入时校验不过
+template<typename NodeT>
+static uint32_t entryOf(const vector<pair<string_view, string_view>>& words, const NodeT* node) {
+    auto it = lower_bound(words.begin(), words.end(), node->key,
+                          [](const pair<string_view, string_view>& w, string_view key) { return w.first < key; });
+    while (it != words.end() && it->first == node->key && it->second != node->value) ++it;
+    if (it == words.end() || it->first != node->key) return static_cast<uint32_t>(words.size());
+    return static_cast<uint32_t>(it - words.begin());
+}
+
+// 先序展开一棵树，子节点总是排在父节点之后；返回根的下标
+template<typename NodeT, typename AuxFn>
+static int32_t flattenTree(const NodeT* root, const vector<pair<string_view, string_view>>& words,
+                           vector<Node>& nodes, AuxFn aux) {
+    if (!root) return -1;
+    auto append = [&](const NodeT* node) {
+        nodes.push_back({entryOf(words, node), -1, -1, aux(node)});
+        return static_cast<int32_t>(nodes.size() - 1);
+    };
+    int32_t rootIndex = append(root);
+    vector<pair<const NodeT*, int32_t>> stack{{root, rootIndex}};
+    while (!stack.empty()) {
+        auto [node, at] = stack.back();
+        stack.pop_back();
+        if (node->left) {
+            int32_t child = append(node->left);
+            nodes[at].left = child;
+            stack.push_back({node->left, child});
+        }
+        if (node->right) {
+            int32_t child = append(node->right);
+            nodes[at].right = child;
+            stack.push_back({node->right, child});
+        }
+    }
+    return rootIndex;
+}
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+bool DictionarySnapshot::save(const DictionaryIndex& index, const QString& fileName, const SourceStamp& source) {
+    const auto& words = index.m_allWords;
+
+    string strings;
+    vector<Entry> entries;
+    entries.reserve(words.size());
+    for (const auto& [word, meaning] : words) {
+        if (strings.size() + word.size() + meaning.size() > numeric_limits<uint32_t>::max()) return false;
+        Entry entry;
+        entry.wordOffset = static_cast<uint32_t>(strings.size());
+        entry.wordLength = static_cast<uint32_t>(word.size());
+        strings += word;
+        entry.meaningOffset = static_cast<uint32_t>(strings.size());
+        entry.meaningLength = static_cast<uint32_t>(meaning.size());
+        strings += meaning;
+        entries.push_back(entry);
+    }
+
+    vector<Shard> shards;
+    vector<Node> nodes[kTreeCount];
+    for (const auto& [firstChar, bstRoot] : index.bstMap) {
+        Shard shard;
+        shard.firstChar = firstChar;
+        shard.root[0] = flattenTree(bstRoot, words, nodes[0], [](const BSTNode*) { return 0; });
+        shard.root[1] = flattenTree(index.avlRoot(firstChar), words, nodes[1],
+                                    [](const AVLNode* n) { return n->height; });
+        shard.root[2] = flattenTree(index.rbRoot(firstChar), words, nodes[2],
+                                    [](const RBNode* n) { return n->isRed ? 1 : 0; });
+        shards.push_back(shard);
+    }
+
+    Header header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(Header);
+    header.sourceSize = source.size;
+    header.sourceMtime = source.mtime;
+    header.wordCount = static_cast<uint32_t>(entries.size());
+    header.shardCount = static_cast<uint32_t>(shards.size());
+    uint64_t offset = alignUp(sizeof(Header));
+    header.stringsOffset = offset;
+    header.stringsSize = strings.size();
+    offset = alignUp(offset + strings.size());
+    header.entriesOffset = offset;
+    offset = alignUp(offset + entries.size() * sizeof(Entry));
+    header.shardsOffset = offset;
+    offset = alignUp(offset + shards.size() * sizeof(Shard));
+    for (int t = 0; t < kTreeCount; ++t) {
+        header.nodesOffset[t] = offset;
+        header.nodeCount[t] = static_cast<uint32_t>(nodes[t].size());
+        offset = alignUp(offset + nodes[t].size() * sizeof(Node));
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    uint64_t written = 0;
+    bool ok = true;
+    auto writeAt = [&](uint64_t at, const void* data, uint64_t size) {
+        static const char padding[8] = {};
+        if (at > written) ok = ok && file.write(padding, at - written) == qint64(at - written);
+        ok = ok && file.write(static_cast<const char*>(data), size) == qint64(size);
+        written = at + size;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.stringsOffset, strings.data(), strings.size());
+    writeAt(header.entriesOffset, entries.data(), entries.size() * sizeof(Entry));
+    writeAt(header.shardsOffset, shards.data(), shards.size() * sizeof(Shard));
+    for (int t = 0; t < kTreeCount; ++t) {
+        writeAt(header.nodesOffset[t], nodes[t].data(), nodes[t].size() * sizeof(Node));
+    }
+    if (!ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+// [offset, offset + count * size) 是否落在文件内
+static bool fits(uint64_t fileSize, uint64_t offset, uint64_t count, uint64_t size) {
+    return offset <= fileSize && count <= (fileSize - offset) / size;
+}
+
+// 检查一段节点表：下标不越界，每个节点至多被引用一次，且子节点在父节点之后（保证无环）
+static bool validTree(const Node* nodes, uint32_t count, uint32_t wordCount, vector<char>& referenced) {
+    referenced.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (nodes[i].entry >= wordCount) return false;
+        for (int32_t child : {nodes[i].left, nodes[i].right}) {
+            if (child == -1) continue;
+            if (child <= int32_t(i) || uint32_t(child) >= count || referenced[child]) return false;
+            referenced[child] = 1;
+        }
+    }
+    return true;
+}
+
+// 按快照中的拓扑直接连接节点，不做任何比较和旋转；整段节点放在分配器的同一块中
+template<typename NodeT, typename InitFn>
+static vector<NodeT*> buildTree(NodeArena<NodeT>& arena, const Node* nodes, uint32_t count,
+                                const vector<pair<string_view, string_view>>& words, InitFn init) {
+    vector<NodeT*> built(count);
+    arena.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& [word, meaning] = words[nodes[i].entry];
+        built[i] = arena.create(word, meaning);
+        init(built[i], nodes[i].aux);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (nodes[i].left != -1) built[i]->left = built[nodes[i].left];
+        if (nodes[i].right != -1) built[i]->right = built[nodes[i].right];
+    }
+    return built;
+}
+
+bool DictionarySnapshot::load(DictionaryIndex& index, const QString& fileName, const SourceStamp& source) {
+    auto mapping = make_unique<MappedFile>();
+    MappedFile& file = *mapping;
+    if (!file.open(fileName) || file.size() < sizeof(Header)) return false;
+
+    Header header;
+    memcpy(&header, file.data(), sizeof(Header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+        || header.headerSize != sizeof(Header)) {
+        return false;
+    }
+    if (header.sourceSize != source.size || header.sourceMtime != source.mtime) return false;
+
+    const uint64_t fileSize = file.size();
+    if (!fits(fileSize, header.stringsOffset, header.stringsSize, 1)
+        || !fits(fileSize, header.entriesOffset, header.wordCount, sizeof(Entry))
+        || !fits(fileSize, header.shardsOffset, header.shardCount, sizeof(Shard))) {
+        return false;
+    }
+    for (int t = 0; t < kTreeCount; ++t) {
+        if (!fits(fileSize, header.nodesOffset[t], header.nodeCount[t], sizeof(Node))
+            || header.nodeCount[t] > uint32_t(numeric_limits<int32_t>::max())) {
+            return false;
+        }
+    }
+
+    // 各段都按 8 字节对齐写出，映射首地址按页对齐，可以直接按结构体访问
+    const char* strings = file.data() + header.stringsOffset;
+    const auto* entries = reinterpret_cast<const Entry*>(file.data() + header.entriesOffset);
+    const auto* shards = reinterpret_cast<const Shard*>(file.data() + header.shardsOffset);
+    const Node* nodes[kTreeCount];
+    for (int t = 0; t < kTreeCount; ++t) {
+        nodes[t] = reinterpret_cast<const Node*>(file.data() + header.nodesOffset[t]);
+    }
+
+    // 先完整校验，再分配任何节点
+    for (uint32_t i = 0; i < header.wordCount; ++i) {
+        const Entry& e = entries[i];
+        if (uint64_t(e.wordOffset) + e.wordLength > header.stringsSize
+            || uint64_t(e.meaningOffset) + e.meaningLength > header.stringsSize || e.wordLength == 0) {
+            return false;
+        }
+    }
+    vector<char> referenced[kTreeCount];
+    for (int t = 0; t < kTreeCount; ++t) {
+        if (!validTree(nodes[t], header.nodeCount[t], header.wordCount, referenced[t])) return false;
+    }
+    for (uint32_t s = 0; s < header.shardCount; ++s) {
+        // 分片按首字母严格递增写出
+        if (shards[s].firstChar < -128 || shards[s].firstChar > 127
+            || (s > 0 && shards[s].firstChar <= shards[s - 1].firstChar)) {
+            return false;
+        }
+        for (int t = 0; t < kTreeCount; ++t) {
+            int32_t root = shards[s].root[t];
+            if (root == -1) continue;
+            if (uint32_t(root) >= header.nodeCount[t] || referenced[t][root]) return false;
+            referenced[t][root] = 1;
+        }
+    }
+    // 每个节点都必须挂在某棵树上，否则建出来会泄漏
+    for (int t = 0; t < kTreeCount; ++t) {
+        if (count(referenced[t].begin(), referenced[t].end(), 0) != 0) return false;
+    }
+
+    // 字符串不拷贝：词条和节点直接指向映射中的字符串区，映射交给字符串池保管
+    vector<pair<string_view, string_view>> words;
+    words.reserve(header.wordCount);
+    for (uint32_t i = 0; i < header.wordCount; ++i) {
+        const Entry& e = entries[i];
+        words.emplace_back(string_view(strings + e.wordOffset, e.wordLength),
+                           string_view(strings + e.meaningOffset, e.meaningLength));
+    }
+    // 二分、基数树和 entryOf 都假定词条按单词排好序，乱序的快照按损坏处理，由调用方改读 CSV
+    auto byWord = [](const pair<string_view, string_view>& a, const pair<string_view, string_view>& b) {
+        return a.first < b.first;
+    };
+    if (!is_sorted(words.begin(), words.end(), byWord)) return false;
+
+    auto bst = buildTree(index.m_bstArena, nodes[0], header.nodeCount[0], words, [](BSTNode*, int32_t) {});
+    auto avl = buildTree(index.m_avlArena, nodes[1], header.nodeCount[1], words,
+                         [](AVLNode* n, int32_t aux) { n->height = aux; });
+    auto rb = buildTree(index.m_rbArena, nodes[2], header.nodeCount[2], words,
+                        [](RBNode* n, int32_t aux) { n->isRed = aux != 0; });
+    for (RBNode* node : rb) {
+        if (node->left) node->left->parent = node;
+        if (node->right) node->right->parent = node;
+    }
+
+    for (uint32_t s = 0; s < header.shardCount; ++s) {
+        char firstChar = static_cast<char>(shards[s].firstChar);
+        const int32_t* root = shards[s].root;
+        index.bstMap[firstChar] = root[0] == -1 ? nullptr : bst[root[0]];
+        index.avlMap[firstChar] = root[1] == -1 ? nullptr : avl[root[1]];
+        index.rbMap[firstChar] = root[2] == -1 ? nullptr : rb[root[2]];
+    }
+    index.m_allWords = std::move(words);
+    index.m_strings.adopt(std::move(mapping));
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef DICTIONARYSNAPSHOT_H
+#define DICTIONARYSNAPSHOT_H
+
+#include "dictionaryindex.h"
+#include <QString>
+#include <cstdint>
+
+// 索引快照：首次从 CSV 建好索引后写出，之后启动时直接映射读入。
+// 文件布局（小端，所有偏移相对文件开头）：
+//   SnapshotHeader
+//   字符串区      所有单词和释义的 UTF-8 字节，首尾相接
+//   词条表        SnapshotEntry[wordCount]，与排序后的 m_allWords 一一对应
+//   分片表        SnapshotShard[shardCount]，每种树在该首字母下的根节点
+//   节点表 ×3     SnapshotNode[nodeCount[e]]，BST / AVL / 红黑树各一段
+namespace snapshot {
+
+const char kMagic[8] = {'D', 'I', 'C', 'T', 'I', 'D', 'X', '\0'};
+const uint32_t kVersion = 2; // 2：词条按单词稳定排序，树由有序区间直接建成
+const int kTreeCount = 3; // BST、AVL、红黑树
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t sourceSize;    // CSV 大小，和修改时间一起判断快照是否过期
+    int64_t sourceMtime;    // CSV 修改时间，毫秒
+    uint32_t wordCount;
+    uint32_t shardCount;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t entriesOffset;
+    uint64_t shardsOffset;
+    uint64_t nodesOffset[kTreeCount];
+    uint32_t nodeCount[kTreeCount];
+    uint32_t reserved;
+};
+
+struct Entry {
+    uint32_t wordOffset;
+    uint32_t wordLength;
+    uint32_t meaningOffset;
+    uint32_t meaningLength;
+};
+
+struct Shard {
+    int32_t firstChar;
+    int32_t root[kTreeCount]; // 节点表下标，-1 表示空树
+};
+
+struct Node {
+    uint32_t entry; // 词条表下标
+    int32_t left;   // 节点表下标，-1 表示空
+    int32_t right;
+    int32_t aux;    // AVL：高度；红黑树：1 为红色；BST 不用
+};
+
+} // namespace snapshot
+
+// 源文件的大小和修改时间
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+class DictionarySnapshot {
+public:
+    static QString pathFor(const QString& csvFileName);
+    static bool stampOf(const QString& fileName, SourceStamp& stamp);
+
+    // 写出所有引擎都已建好的索引；先写临时文件再改名，写到一半不会留下坏快照
+    static bool save(const DictionaryIndex& index, const QString& fileName, const SourceStamp& source);
+    // 快照缺失、版本不符、与 CSV 不匹配或内容越界时返回 false，index 保持为空
+    static bool load(DictionaryIndex& index, const QString& fileName, const SourceStamp& source);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "eytzingerindex.h"
+#include "searchpath.h"
+#include "stringkernels.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DICT_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define DICT_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define DICT_PREFETCH(address) ((void)0)
+#endif
+
+uint64_t EytzingerIndex::prefixOf(string_view word) {
+    uint64_t prefix = 0;
+    size_t length = min<size_t>(word.size(), 8);
+    for (size_t i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | (i < length ? static_cast<unsigned char>(word[i]) : 0);
+    }
+    return prefix;
+}
+
+void EytzingerIndex::build(const vector<pair<string_view, string_view>>& words) {
+    m_words = &words;
+    vector<uint32_t> sorted; // 去重后的词表下标
+    sorted.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (i > 0 && words[i].first == words[i - 1].first) continue;
+        sorted.push_back(static_cast<uint32_t>(i));
+    }
+    m_size = sorted.size();
+    // 多留 4 个槽，最后一层的 4k..4k+3 不会越出分配的内存
+    m_slots.reset(static_cast<Slot*>(::operator new((m_size + 4) * sizeof(Slot), align_val_t(64))));
+    memset(m_slots.get(), 0, (m_size + 4) * sizeof(Slot));
+    fill(sorted, 0, 1);
+}
+
+// 中序遍历隐式树，依次放入有序的单词
+size_t EytzingerIndex::fill(const vector<uint32_t>& sorted, size_t i, size_t k) {
+    if (k > m_size) return i;
+    i = fill(sorted, i, 2 * k);
+    string_view word = (*m_words)[sorted[i]].first;
+    m_slots[k] = {prefixOf(word), sorted[i], static_cast<uint32_t>(word.size())};
+    ++i;
+    return fill(sorted, i, 2 * k + 1);
+}
+
+int EytzingerIndex::compare(string_view key, uint64_t keyPrefix, const Slot& slot) const {
+    if (keyPrefix != slot.prefix) return keyPrefix < slot.prefix ? -1 : 1;
+    // 前 8 字节相同且都不超过 8 字节时只需比长度
+    if (key.size() <= 8 && slot.length <= 8) {
+        return key.size() == slot.length ? 0 : (key.size() < slot.length ? -1 : 1);
+    }
+    return compareBytes(key, (*m_words)[slot.entry].first);
+}
+
+template <typename Path>
+bool EytzingerIndex::search(string_view key, Path& path, string_view& result) const {
+    uint64_t keyPrefix = prefixOf(key);
+    size_t k = 1;
+    while (k <= m_size) {
+        if (4 * k <= m_size) DICT_PREFETCH(m_slots.get() + 4 * k); // 两层之后的 4 个槽在同一条缓存行
+        const Slot& slot = m_slots[k];
+        path.visit((*m_words)[slot.entry].first);
+        int comparison = compare(key, keyPrefix, slot);
+        if (comparison == 0) {
+            result = (*m_words)[slot.entry].second;
+            return true;
+        }
+        k = 2 * k + (comparison > 0);
+    }
+    return false;
+}
+
+template bool EytzingerIndex::search(string_view, NoPath&, string_view&) const;
+template bool EytzingerIndex::search(string_view, PathRecorder&, string_view&) const;
+template bool EytzingerIndex::search(string_view, QueryProbe&, string_view&) const;
@@ -0,0 +1,47 @@
+#ifndef EYTZINGERINDEX_H
+#define EYTZINGERINDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 静态的 Eytzinger（BFS 顺序）布局：有序单词按完全二叉树的层序排进一个数组，
+// 下标 k 的孩子是 2k 和 2k+1，不用指针。每个槽 16 字节，一条缓存行放 4 个，
+// 向下走两层之前预取孙子所在的整条缓存行。槽里存单词前 8 字节的大端整数，
+// 多数比较不用访问字符串池
+class EytzingerIndex {
+public:
+    // words 必须按单词排好序（允许重复，重复的取第一条），并在本索引的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words);
+
+    // 与各树的 search 一致：path 访问比较过的单词，只对 searchpath.h 中的三种访问者实例化
+    template <typename Path>
+    bool search(string_view key, Path& path, string_view& result) const;
+
+    size_t size() const { return m_size; }
+    size_t memoryBytes() const { return (m_size + 4) * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint64_t prefix;  // 前 8 字节，大端，不足补 0
+        uint32_t entry;   // 词表下标
+        uint32_t length;
+    };
+    struct AlignedDelete {
+        void operator()(Slot* data) const { ::operator delete(data, align_val_t(64)); }
+    };
+
+    static uint64_t prefixOf(string_view word);
+    int compare(string_view key, uint64_t keyPrefix, const Slot& slot) const;
+    size_t fill(const vector<uint32_t>& sorted, size_t i, size_t k);
+
+    const vector<pair<string_view, string_view>>* m_words = nullptr;
+    unique_ptr<Slot[], AlignedDelete> m_slots; // 下标从 1 开始，按 64 字节对齐
+    size_t m_size = 0;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "fuzzysearch.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+
+int boundedEditDistance(string_view a, string_view b, int limit) {
+    if (a.size() > b.size()) swap(a, b);
+    if (int(b.size() - a.size()) > limit) return limit + 1;
+
+    // 只保留一行；每行的最小值超过 limit 后不可能再变小
+    int row[64 + 1];
+    vector<int> heapRow;
+    int* previous = row;
+    if (a.size() + 1 > size(row)) {
+        heapRow.resize(a.size() + 1);
+        previous = heapRow.data();
+    }
+    for (size_t i = 0; i <= a.size(); ++i) previous[i] = int(i);
+    for (size_t j = 1; j <= b.size(); ++j) {
+        int diagonal = previous[0];
+        previous[0] = int(j);
+        int rowMin = previous[0];
+        for (size_t i = 1; i <= a.size(); ++i) {
+            int above = previous[i];
+            previous[i] = min({above + 1, previous[i - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+            rowMin = min(rowMin, previous[i]);
+        }
+        if (rowMin > limit) return limit + 1;
+    }
+    return min(previous[a.size()], limit + 1);
+}
+
+static uint64_t hashOf(string_view text) {
+    return hash<string_view>()(text);
+}
+
+// text 删去 1..remaining 个字符的全部变形（含重复），交给 emit
+template<typename EmitFn>
+static void forEachDelete(string& text, size_t from, int remaining, EmitFn& emit) {
+    if (remaining == 0) return;
+    for (size_t i = from; i < text.size(); ++i) {
+        char removed = text[i];
+        text.erase(i, 1);
+        emit(string_view(text));
+        forEachDelete(text, i, remaining - 1, emit);
+        text.insert(text.begin() + i, removed);
+    }
+}
+
+void SymSpellIndex::build(const vector<pair<string_view, string_view>>& words, int maxDistance) {
+    m_words = &words;
+    m_maxDistance = maxDistance;
+    m_deletes.clear();
+    string scratch;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (i > 0 && words[i].first == words[i - 1].first) continue;
+        uint32_t entry = static_cast<uint32_t>(i);
+        scratch.assign(words[i].first.substr(0, kPrefixLength));
+        auto emit = [&](string_view variant) { m_deletes.push_back({hashOf(variant), entry}); };
+        emit(scratch);
+        forEachDelete(scratch, 0, maxDistance, emit);
+    }
+    sort(m_deletes.begin(), m_deletes.end(), [](const Delete& a, const Delete& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.entry < b.entry;
+    });
+    m_deletes.erase(unique(m_deletes.begin(), m_deletes.end(),
+                           [](const Delete& a, const Delete& b) { return a.hash == b.hash && a.entry == b.entry; }),
+                    m_deletes.end());
+    m_deletes.shrink_to_fit();
+}
+
+vector<FuzzyMatch> SymSpellIndex::search(string_view word, int maxDistance) const {
+    maxDistance = min(maxDistance, m_maxDistance);
+    vector<uint32_t> candidates;
+    string scratch(word.substr(0, kPrefixLength));
+    auto emit = [&](string_view variant) {
+        uint64_t hash = hashOf(variant);
+        auto it = lower_bound(m_deletes.begin(), m_deletes.end(), hash,
+                              [](const Delete& d, uint64_t h) { return d.hash < h; });
+        for (; it != m_deletes.end() && it->hash == hash; ++it) candidates.push_back(it->entry);
+    };
+    emit(scratch);
+    forEachDelete(scratch, 0, maxDistance, emit);
+
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+    vector<FuzzyMatch> matches;
+    for (uint32_t entry : candidates) {
+        int distance = boundedEditDistance(word, (*m_words)[entry].first, maxDistance);
+        if (distance <= maxDistance) matches.push_back({entry, distance});
+    }
+    stable_sort(matches.begin(), matches.end(),
+                [](const FuzzyMatch& a, const FuzzyMatch& b) { return a.distance < b.distance; });
+    return matches;
+}
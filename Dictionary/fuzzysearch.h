@@ -0,0 +1,48 @@
+#ifndef FUZZYSEARCH_H
+#define FUZZYSEARCH_H
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// 近似查找的公共部分。距离按 Levenshtein 编辑距离（插入、删除、替换各算 1）
+
+struct FuzzyMatch {
+    uint32_t entry; // 词表下标
+    int distance;
+};
+
+// a 与 b 的编辑距离；超过 limit 时提前结束并返回 limit + 1
+int boundedEditDistance(string_view a, string_view b, int limit);
+
+// SymSpell 式的删除索引：预先把每个单词删去至多 maxDistance 个字符的所有变形记下来，
+// 查询时只生成查询词的删除变形去对照，不用枚举插入和替换。
+// 只对前 kPrefixLength 个字符生成变形，否则长词的变形数会爆炸；候选词最后用完整的编辑距离核对。
+// 变形只存 64 位哈希和词表下标，哈希冲突同样由核对排除
+class SymSpellIndex {
+public:
+    static const int kPrefixLength = 7;
+
+    // words 必须按单词排好序（允许重复，重复的取第一条），并在本索引的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words, int maxDistance);
+
+    // 全部距离不超过 maxDistance（不大于建立时的值）的单词，按距离再按词表顺序排列
+    vector<FuzzyMatch> search(string_view word, int maxDistance) const;
+
+    size_t size() const { return m_deletes.size(); }
+    size_t memoryBytes() const { return m_deletes.capacity() * sizeof(Delete); }
+
+private:
+    struct Delete {
+        uint64_t hash;
+        uint32_t entry;
+    };
+
+    const vector<pair<string_view, string_view>>* m_words = nullptr;
+    vector<Delete> m_deletes; // 按哈希排序
+    int m_maxDistance = 0;
+};
+
+#endif
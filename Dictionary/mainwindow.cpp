@@ -1,8 +1,15 @@
 #include "mainwindow.h"
+#include "dictionaryloader.h"
+#include "memoryreport.h"
+#include "perfcounter.h"
+#include "suggestionworker.h"
+#include "treestats.h"
+#include <QFontDatabase>
+#include <QMenuBar>
 #include <QVBoxLayout>
-#include <QFile>
-#include <QTextStream>
+#include <QStatusBar>
 #include <QMessageBox>
+#include <QDebug>
 #include <algorithm>
 #include <QTextEdit>
 
@@ -26,435 +33,185 @@ MainWindow::MainWindow(QWidget* parent)
 
     setCentralWidget(central);
 
-    // 加载字典文件
-    loadDictionary("E:/code qt/Dictionary/EnWords.csv");
+    // 加载进度
+    progressBar = new QProgressBar(this);
+    progressBar->setRange(0, 100);
+    progressBar->setMaximumWidth(160);
+    statusBar()->addPermanentWidget(progressBar);
+
+    QMenu* diagnosticsMenu = menuBar()->addMenu("诊断");
+    diagnosticsMenu->addAction("树的形状统计", this, &MainWindow::showTreeStatistics);
+    diagnosticsMenu->addAction("各引擎内存", this, &MainWindow::showMemoryUsage);
 
     connect(lineEdit, &QLineEdit::textChanged, this, &MainWindow::on_lineEdit_textChanged);
     connect(searchButton, &QPushButton::clicked, this, &MainWindow::on_buttonClicked);
-}
-
-MainWindow::~MainWindow() {
-    deleteAllBSTs();
-    deleteAllAVLs();
-}
-
-void MainWindow::loadDictionary(const QString& fileName) {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "错误", "无法打开字典文件！");
-        return;
-    }
-
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.isEmpty()) continue;
-        line = line.mid(1, line.length() - 2);
-
-        QStringList parts = line.split("\",\"");
-        if (parts.size() == 1) {
-            qWarning() << "信息缺失行:" << line;
-           continue;
-        }
-
-        string word = parts[0].toStdString();
-        string meaning = parts[1].toStdString();
-        m_allWords.emplace_back(word, meaning);
-
-        // 按首字母插入对应的树
-        char firstChar = tolower(word[0]);
-        if (bstMap.find(firstChar) == bstMap.end()) {
-            bstMap[firstChar] = nullptr; // 初始化一个新的树
-        }
-        bstMap[firstChar] = insertBST(bstMap[firstChar], word, meaning);
-
-        // 对AVL树进行插入
-     if (avlMap.find(firstChar) == avlMap.end()) {
-            avlMap[firstChar] = nullptr;
-        }
-        avlMap[firstChar] = insertAVL(avlMap[firstChar], word, meaning);
-
-        // 插入 RB
-      if (rbMap.find(firstChar) == rbMap.end()) {
-            rbMap[firstChar] = nullptr;
-        }
-        rbMap[firstChar] = insertRB(rbMap[firstChar], word, meaning);
-    }
-    file.close();
-    sort(m_allWords.begin(), m_allWords.end());
-}
-
-
-vector<string> MainWindow::prefixSearchSequential(const string& prefix, int maxResults) {
-    vector<string> results;
-    for (const auto& pair : m_allWords) {
-        if (pair.first.find(prefix) == 0) {
-            results.push_back(pair.first);
-            if ((int)results.size() >= maxResults) break;//最多限制
-        }
-    }
-    return results;
-}
-
-vector<string> MainWindow::prefixSearchBST(BSTNode* root, const string& prefix, int maxResults) {
-    vector<string> results;
-    function<void(BSTNode*)> dfs = [&](BSTNode* node) {
-        if (!node || (int)results.size() >= maxResults) return;
-        if (node->key.find(prefix) == 0) results.push_back(node->key);
-        if (node->key >= prefix) dfs(node->left);
-        dfs(node->right);
-    };
-    dfs(root);
-    return results;
-}
-
-
-
-vector<string> MainWindow::prefixSearchAVL(AVLNode* root, const string& prefix, int maxResults) {
-    vector<string> results;
-    function<void(AVLNode*)> dfs = [&](AVLNode* node) {
-        if (!node || (int)results.size() >= maxResults) return;
-        if (node->key.find(prefix) == 0) results.push_back(node->key);
-        if (node->key >= prefix) dfs(node->left);
-        dfs(node->right);
-    };
-    dfs(root);
-    return results;
-}
-
-
-//加箭头显示路径
-string join(const vector<string>& vec, const string& delimiter) {
-    string result;
-    for (size_t i = 0; i < vec.size(); ++i) {
-        result += vec[i];
-        if (i < vec.size() - 1) {
-            result += delimiter;
-        }
-    }
-    return result;
-}
-
-BSTNode* MainWindow::insertBST(BSTNode* root, const string& key, const string& value) {
-    if (!root) return new BSTNode(key, value);
-    int comparison = compareKeys(key, root->key);
-    if (comparison < 0) {
-        root->left = insertBST(root->left, key, value);
-    } else if (comparison > 0) {
-        root->right = insertBST(root->right, key, value);
-    }
-    return root;
-}
-
-AVLNode* MainWindow::insertAVL(AVLNode* root, const string& key, const string& value) {
-    if (!root) return new AVLNode(key, value);
-
-    if (key < root->key) root->left = insertAVL(root->left, key, value);
-    else if (key > root->key) root->right = insertAVL(root->right, key, value);
-    else return root;
-
-    root->height = 1 + max(getHeight(root->left), getHeight(root->right));
-    int balance = getBalance(root);
-
-    if (balance > 1 && key < root->left->key) return rotateRight(root);
-    if (balance < -1 && key > root->right->key) return rotateLeft(root);
-    if (balance > 1 && key > root->left->key) {
-        root->left = rotateLeft(root->left);
-        return rotateRight(root);
-    }
-    if (balance < -1 && key < root->right->key) {
-        root->right = rotateRight(root->right);
-        return rotateLeft(root);
-    }
-    return root;
-}
-
-AVLNode* MainWindow::rotateLeft(AVLNode* x) {
-    AVLNode* y = x->right;
-    AVLNode* T2 = y->left;
-
-    y->left = x;
-    x->right = T2;
-
-    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
-    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
 
-    return y;
+    // 在后台线程加载字典文件，窗口先显示出来
+    m_index = make_shared<DictionaryIndex>();
+    m_loader = new DictionaryLoader(m_index);
+    m_loader->moveToThread(&m_loaderThread);
+    connect(&m_loaderThread, &QThread::finished, m_loader, &QObject::deleteLater);
+    connect(m_loader, &DictionaryLoader::progress, this, &MainWindow::onLoadProgress);
+    connect(m_loader, &DictionaryLoader::engineReady, this, &MainWindow::onEngineReady);
+    connect(m_loader, &DictionaryLoader::failed, this, &MainWindow::onLoadFailed);
+    m_loaderThread.start();
+    QMetaObject::invokeMethod(m_loader, [loader = m_loader]() {
+        loader->load("E:/code qt/Dictionary/EnWords.csv");
+    }, Qt::QueuedConnection);
+
+    // 输入联想同样放在后台线程，界面线程只负责合并连续的输入和显示结果
+    m_suggester = new SuggestionWorker(m_index);
+    m_suggester->moveToThread(&m_suggestThread);
+    connect(&m_suggestThread, &QThread::finished, m_suggester, &QObject::deleteLater);
+    connect(m_suggester, &SuggestionWorker::suggestionsReady, this, &MainWindow::onSuggestionsReady);
+    connect(m_suggester, &SuggestionWorker::suggestionsAppended, this, &MainWindow::onSuggestionsAppended);
+    m_suggestThread.start();
+    m_suggestTimer.setSingleShot(true);
+    m_suggestTimer.setInterval(kSuggestDebounceMs);
+    connect(&m_suggestTimer, &QTimer::timeout, this, &MainWindow::requestSuggestions);
 }
 
-AVLNode* MainWindow::rotateRight(AVLNode* y) {
-    AVLNode* x = y->left;
-    AVLNode* T2 = x->right;
-
-    x->right = y;
-    y->left = T2;
-
-    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
-    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
-
-    return x;
-}
-
-int MainWindow::getHeight(AVLNode* node) {
-    return node ? node->height : 0;
-}
-
-int MainWindow::getBalance(AVLNode* node) {
-    return node ? getHeight(node->left) - getHeight(node->right) : 0;
+MainWindow::~MainWindow() {
+    // 关闭时加载可能仍在进行，等它在下一个阶段边界退出
+    m_loaderThread.requestInterruption();
+    m_loaderThread.quit();
+    m_loaderThread.wait();
+    m_suggestThread.quit();
+    m_suggestThread.wait();
 }
-RBNode* MainWindow::insertRB(RBNode* root, const string& key, const string& value) {
-    // 插入新的节点
-    RBNode* newNode = new RBNode(key, value);
-    if (root == nullptr) {
-        newNode->isRed = false;  // 根节点总是黑色
-        return newNode;
-    }
 
-    RBNode* parent = nullptr;
-    RBNode* current = root;
-
-    // 通过普通的二叉查找树插入新节点
-    while (current != nullptr) {
-        parent = current;
-        if (key < current->key) {
-            current = current->left;
-        } else if (key > current->key) {
-            current = current->right;
-        } else {
-            current->value = value;  // 如果关键字相等，更新值
-            delete newNode;          // 释放新节点并返回当前根节点
-            return root;
-        }
-    }
-
-    // 设置父节点
-    newNode->parent = parent;
-    if (key < parent->key) {
-        parent->left = newNode;
+void MainWindow::onLoadProgress(int percent, const QString& stage) {
+    progressBar->setValue(percent);
+    if (percent >= 100) {
+        progressBar->hide();
+        statusBar()->showMessage(stage, 3000);
     } else {
-        parent->right = newNode;
+        statusBar()->showMessage(QString("%1…").arg(stage));
     }
-
-    // 2. 修正红黑树性质
-    return fixInsertRB(root, newNode);
 }
 
-RBNode* MainWindow::fixInsertRB(RBNode* root, RBNode* node) {
-    // 如果父节点是黑色或是根节点，直接返回
-    while (node != root && node->parent->isRed == true) {
-        if (node->parent == node->parent->parent->left) { // 父节点是左子树
-            RBNode* uncle = node->parent->parent->right;
-            if (uncle && uncle->isRed == true) { // Case 1: 叔叔是红色
-                node->parent->isRed = false;      // 父节点变黑
-                uncle->isRed = false;             // 叔叔变黑
-                node->parent->parent->isRed = true; // 祖父节点变红
-                node = node->parent->parent;        // 向上调整
-            } else { // Case 2: 叔叔是黑色
-                if (node == node->parent->right) { // Case 2a: 插入的是右子节点
-                    node = node->parent;
-                    root = leftRotateRB(root, node);  // 左旋
-                }
-                node->parent->isRed = false;       // 父节点变黑
-                node->parent->parent->isRed = true; // 祖父节点变红
-                root = rightRotateRB(root, node->parent->parent); // 右旋
-            }
-        } else { // 父节点是右子树
-            RBNode* uncle = node->parent->parent->left;
-            if (uncle && uncle->isRed == true) { // Case 1: 叔叔是红色
-                node->parent->isRed = false;      // 父节点变黑
-                uncle->isRed = false;             // 叔叔变黑
-                node->parent->parent->isRed = true; // 祖父节点变红
-                node = node->parent->parent;        // 向上调整
-            } else { // Case 2: 叔叔是黑色
-                if (node == node->parent->left) { // Case 2a: 插入的是左子节点
-                    node = node->parent;
-                    root = rightRotateRB(root, node); // 右旋
-                }
-                node->parent->isRed = false;       // 父节点变黑
-                node->parent->parent->isRed = true; // 祖父节点变红
-                root = leftRotateRB(root, node->parent->parent); // 左旋
-            }
-        }
-    }
-    root->isRed = false; // 根节点必须是黑色
-    return root;
+void MainWindow::onEngineReady(int engine) {
+    qInfo().noquote() << QString("%1已可查询").arg(engineName(static_cast<Engine>(engine)));
+    // 更快的引擎就绪后刷新当前的候选词
+    if (!lineEdit->text().isEmpty()) on_lineEdit_textChanged(lineEdit->text());
 }
 
-// 左旋操作
-RBNode* MainWindow::leftRotateRB(RBNode* root, RBNode* node) {
-    RBNode* rightChild = node->right;
-    node->right = rightChild->left;
-    if (rightChild->left != nullptr) {
-        rightChild->left->parent = node;
-    }
-    rightChild->parent = node->parent;
-    if (node->parent == nullptr) {
-        root = rightChild; // 如果旋转的是根节点，更新根节点
-    } else if (node == node->parent->left) {
-        node->parent->left = rightChild;
-    } else {
-        node->parent->right = rightChild;
-    }
-    rightChild->left = node;
-    node->parent = rightChild;
-
-    return root;
+void MainWindow::onLoadFailed(const QString& message) {
+    progressBar->hide();
+    statusBar()->showMessage(message);
+    QMessageBox::warning(this, "错误", message);
 }
 
-// 右旋操作
-RBNode* MainWindow::rightRotateRB(RBNode* root, RBNode* node) {
-    RBNode* leftChild = node->left;
-    node->left = leftChild->right;
-    if (leftChild->right != nullptr) {
-        leftChild->right->parent = node;
-    }
-    leftChild->parent = node->parent;
-    if (node->parent == nullptr) {
-        root = leftChild; // 如果旋转的是根节点，更新根节点
-    } else if (node == node->parent->right) {
-        node->parent->right = leftChild;
-    } else {
-        node->parent->left = leftChild;
-    }
-    leftChild->right = node;
-    node->parent = leftChild;
-
-    return root;
-}
-
-
-bool MainWindow::sequentialSearch(const string& key, vector<string>& path, string& result) {
-    path.clear();
-    for (const auto& wordPair : m_allWords) {
-        path.push_back(wordPair.first);
-        if (wordPair.first == key) {
-            result = wordPair.second;
-            return true;
-        }
+void MainWindow::on_lineEdit_textChanged(const QString& text) {
+    // 新的输入使所有未完成的联想作废，停顿一会儿再发出请求
+    m_suggestGeneration = m_suggester->nextGeneration();
+    m_keystrokeTime = chrono::steady_clock::now();
+    if (text.isEmpty()) {
+        m_suggestTimer.stop();
+        listWidget->clear();
+        return;
     }
-    return false;
-}
-
-//search函数
-bool MainWindow::searchBST(BSTNode* root, const string& key, vector<string>& path, string& result) {
-    if (!root) return false;
-    path.push_back(root->key);
-    int comparison = compareKeys(key, root->key);
-    if (comparison == 0) {
-        result = root->value;
-        return true;
+    if (!m_index->isReady(SuggestionWorker::isReverseQuery(text) ? Engine::Reverse : Engine::SortedArray)) {
+        m_suggestTimer.stop();
+        listWidget->clear();
+        QListWidgetItem* item = new QListWidgetItem("正在建立索引…");
+        item->setFlags(Qt::NoItemFlags);
+        listWidget->addItem(item);
+        return;
     }
-    if (comparison < 0) return searchBST(root->left, key, path, result);
-    return searchBST(root->right, key, path, result);
+    m_suggestTimer.start();
 }
 
-bool MainWindow::searchAVL(AVLNode* root, const string& key, vector<string>& path, string& result) {
-    if (!root) return false;
-    path.push_back(root->key);
-    int comparison = compareKeys(key, root->key);
-    if (comparison == 0) {
-        result = root->value;
-        return true;
-    }
-    if (comparison < 0) return searchAVL(root->left, key, path, result);
-    return searchAVL(root->right, key, path, result);
+void MainWindow::requestSuggestions() {
+    QMetaObject::invokeMethod(m_suggester, [suggester = m_suggester, generation = m_suggestGeneration,
+                                            prefix = lineEdit->text()]() {
+        suggester->suggest(generation, prefix);
+    }, Qt::QueuedConnection);
 }
 
-// 搜索 RB 函数实现
-bool MainWindow::searchRB(RBNode* root, const string& key, vector<string>& path, string& result) {
-    while (root) {
-        path.push_back(root->key);
-        int comparison = compareKeys(key, root->key);
-        if (comparison == 0) {
-            result = root->value;
-            return true;
-        } else if (comparison < 0) {
-            root = root->left;
-        } else {
-            root = root->right;
-        }
-    }
-    return false;
+void MainWindow::onSuggestionsReady(quint64 generation, const QStringList& words, double searchMicros) {
+    // 结果发出后又有输入，丢弃
+    if (generation != m_suggestGeneration) return;
+    listWidget->clear();
+    listWidget->addItems(words);
+    auto rendered = chrono::steady_clock::now();
+    qDebug().noquote() << QString("联想 \"%1\"：输入到显示 %2 ms（含 %3 ms 合并输入），查找 %4 µs")
+                              .arg(lineEdit->text())
+                              .arg(chrono::duration<double, milli>(rendered - m_keystrokeTime).count(), 0, 'f', 1)
+                              .arg(kSuggestDebounceMs)
+                              .arg(searchMicros, 0, 'f', 1);
 }
 
-// 删除红黑树
-void MainWindow::deleteRB(RBNode* root) {
-    if (!root) return;
-    deleteRB(root->left);
-    deleteRB(root->right);
-    delete root;
+void MainWindow::onSuggestionsAppended(quint64 generation, const QStringList& words) {
+    if (generation != m_suggestGeneration) return;
+    listWidget->addItems(words);
 }
 
-void MainWindow::deleteAllRBs() {
-    for (auto& [key, root] : rbMap) {
-        deleteRB(root);
-    }
-    rbMap.clear();
+void MainWindow::showDiagnostics(const QString& title, const QString& text) {
+    QWidget* window = new QWidget(nullptr);
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->setWindowTitle(title);
+    QVBoxLayout* windowLayout = new QVBoxLayout(window);
+    QTextEdit* textEdit = new QTextEdit(window);
+    // 表格按列对齐，用等宽字体
+    textEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    textEdit->setLineWrapMode(QTextEdit::NoWrap);
+    textEdit->setPlainText(text);
+    textEdit->setReadOnly(true);
+    windowLayout->addWidget(textEdit);
+    window->resize(720, 600);
+    window->show();
 }
 
-int MainWindow::compareKeys(const string& a, const string& b) {
-    size_t minLength = min(a.length(), b.length());
-    for (size_t i = 0; i < minLength; ++i) {
-        if (a[i] < b[i]) return -1;
-        if (a[i] > b[i]) return 1;
+void MainWindow::showTreeStatistics() {
+    if (!m_index->isReady(Engine::BST)) {
+        QMessageBox::information(this, "提示", "树索引仍在建立，请稍候再查看。");
+        return;
     }
-    if (a.length() < b.length()) return -1;
-    if (a.length() > b.length()) return 1;
-    return 0;
+    showDiagnostics("树的形状统计", treeShapeReport(*m_index));
 }
 
-void MainWindow::deleteBST(BSTNode* root) {
-    if (!root) return;
-    deleteBST(root->left);
-    deleteBST(root->right);
-    delete root;
-}
-void MainWindow::deleteAllBSTs() {
-    for (auto& [key, root] : bstMap) {
-        deleteBST(root);
+void MainWindow::showMemoryUsage() {
+    if (!m_index->isReady(Engine::Sequential)) {
+        QMessageBox::information(this, "提示", "词典仍在加载，请稍候再查看。");
+        return;
     }
-    bstMap.clear();
+    showDiagnostics("各引擎内存", engineMemoryReport(*m_index));
 }
 
-void MainWindow::deleteAVL(AVLNode* root) {
-    if (!root) return;
-    deleteAVL(root->left);
-    deleteAVL(root->right);
-    delete root;
+// 只包住查找调用本身，结果窗口的构造和显示不计入；一次查找通常不到一微秒到几十微秒，按微秒显示
+template<typename Func>
+chrono::duration<double, micro> measureExecutionTime(Func&& func) {
+    auto start = chrono::steady_clock::now();
+    func();
+    auto end = chrono::steady_clock::now();
+    return end - start;
 }
 
-void MainWindow::deleteAllAVLs() {
-    for (auto& [key, root] : avlMap) {
-        deleteAVL(root);
+QString MainWindow::queryStatistics(Engine engine, const string& key) const {
+    QueryProbe probe(key);
+    string_view meaning;
+    m_index->search(engine, key, probe, meaning);
+    QString text = QString("比较 %1 次，访问节点 %2 个，比较 %3 字节")
+                       .arg(probe.comparisons())
+                       .arg(probe.nodes())
+                       .arg(probe.bytesCompared());
+    if (qEnvironmentVariableIsSet("DICT_PERF")) {
+        HardwareCounters counters;
+        NoPath noPath;
+        counters.start();
+        m_index->search(engine, key, noPath, meaning);
+        HardwareCounters::Counts counts = counters.stop();
+        auto format = [&](PerfCounter::Event event, uint64_t count) {
+            return counters.isValid(event) ? QString::number(count) : QString("n/a");
+        };
+        text += QString("\n周期 %1，指令 %2，末级缓存未命中 %3，dTLB 未命中 %4")
+                    .arg(format(PerfCounter::Cycles, counts.cycles))
+                    .arg(format(PerfCounter::Instructions, counts.instructions))
+                    .arg(format(PerfCounter::LlcMisses, counts.llcMisses))
+                    .arg(format(PerfCounter::DtlbMisses, counts.dtlbMisses));
     }
-    avlMap.clear();
-}
-
-void MainWindow::on_lineEdit_textChanged(const QString& text) {
-    listWidget->clear();
-    string prefix = text.toStdString();
-    // if (!prefix.empty()) {
-    //     auto candidates = prefixSearchSequential(prefix);
-    //     for (const auto& word : candidates) {
-    //         listWidget->addItem(QString::fromStdString(word));
-    //     }
-    // }
-    if (!prefix.empty()) {
-       char firstChar = tolower(prefix[0]);
-      if (bstMap.find(firstChar) != bstMap.end()) {
-           auto candidates = prefixSearchBST(bstMap[firstChar], prefix);
-          for (const auto& word : candidates) {
-             listWidget->addItem(QString::fromStdString(word));
-         }
-     }
-   }
-}
-template<typename Func>
-chrono::milliseconds measureExecutionTime(Func&& func) {
-    auto start = chrono::high_resolution_clock::now();
-    func();
-    auto end = chrono::high_resolution_clock::now();
-    return chrono::duration_cast<chrono::milliseconds>(end - start);
+    return text;
 }
 
 void MainWindow::on_buttonClicked() {
@@ -465,29 +222,51 @@ void MainWindow::on_buttonClicked() {
     }
 
     string key = input.toStdString();
-    char firstChar = tolower(key[0]);
-    vector<string> path1,path2,path3,path4;
-    string meaning1,meaning2,meaning3,meaning4;
+    // 路径只记下指向字符串池的视图，释义同样不复制
+    PathRecorder path1,path2,path3,path4,path5,path6;
+    string_view meaning1,meaning2,meaning3,meaning4,meaning5,meaning6;
+
+    if (!m_index->isReady(Engine::Sequential)) {
+        QMessageBox::information(this, "提示", "词典仍在加载，请稍候再查询。");
+        return;
+    }
 
-    if (bstMap.find(firstChar) != bstMap.end() && searchBST(bstMap[firstChar], key, path1, meaning1)) {
+    // 规范化键索引与顺序表同时就绪：先换成词表中的写法，各引擎都按它查找
+    string canonical;
+    bool found = m_index->canonicalWord(key, canonical);
+    if (found) key = canonical;
+    char firstChar = DictionaryIndex::shardOf(key);
+
+    if (found) {
         QMessageBox messageBox(nullptr);
         messageBox.setWindowTitle("查找方法");
         messageBox.setText("请选择查找方法");
 
         // 自定义按钮文本
         QPushButton* btnSequential = messageBox.addButton("顺序查找", QMessageBox::YesRole);
+        QPushButton* btnSorted = messageBox.addButton("二分查找", QMessageBox::NoRole);
         QPushButton* btnBinaryTree = messageBox.addButton("二叉树查找", QMessageBox::NoRole);
         QPushButton* btnAVL = messageBox.addButton("AVL树查找", QMessageBox::YesRole);
         QPushButton* btnRB = messageBox.addButton("红黑树查找", QMessageBox::NoRole);
+        QPushButton* btnEytzinger = messageBox.addButton("Eytzinger查找", QMessageBox::YesRole);
+        // 还在建立的引擎暂不可选
+        const pair<QPushButton*, Engine> engineButtons[] = {
+            {btnSequential, Engine::Sequential}, {btnSorted, Engine::SortedArray}, {btnBinaryTree, Engine::BST},
+            {btnAVL, Engine::AVL}, {btnRB, Engine::RB}, {btnEytzinger, Engine::Eytzinger}};
+        for (const auto& [button, engine] : engineButtons) {
+            if (m_index->isReady(engine)) continue;
+            button->setText(QString("%1（索引中）").arg(engineName(engine)));
+            button->setEnabled(false);
+        }
         // 显示对话框并等待用户选择
         messageBox.exec();
-        chrono::milliseconds elapsedTime;
+        chrono::duration<double, micro> elapsedTime;
         if (messageBox.clickedButton() == btnBinaryTree) {
-        elapsedTime = measureExecutionTime([&]() {
-        searchBST(bstMap[firstChar], key, path1, meaning1);
+        elapsedTime = measureExecutionTime([&]() { m_index->searchBST(m_index->bstRoot(firstChar), key, path1, meaning1); });
         QString message = QString("路径：%1\n解释：%2")
-                              .arg(QString::fromStdString(join(path1, " -> ")))
-                              .arg(QString::fromStdString(meaning1));
+                              .arg(QString::fromStdString(path1.join(" -> ")))
+                              .arg(QString::fromUtf8(meaning1.data(), int(meaning1.size())));
+        message += "\n" + queryStatistics(Engine::BST, key);
 
         QWidget* messageWindow = new QWidget(nullptr);
         messageWindow->setWindowTitle("查询结果");
@@ -501,18 +280,18 @@ void MainWindow::on_buttonClicked() {
         messageWindow->resize(400, 300);
         messageWindow->show();
         QMessageBox::information(this, "翻译为",
-                                 QString::fromStdString(meaning1)); });
+                                 QString::fromUtf8(meaning1.data(), int(meaning1.size())));
 
             // 显示时间
-            QString timeMessage = QString("查询耗时: %1 毫秒").arg(elapsedTime.count());
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
             QMessageBox::information(this, "查询耗时", timeMessage);
         }
 
         else if (messageBox.clickedButton() == btnSequential) {
-            elapsedTime = measureExecutionTime([&]() {
-            sequentialSearch(key,path2,meaning2);
+            elapsedTime = measureExecutionTime([&]() { m_index->sequentialSearch(key,path2,meaning2); });
             // 显示路径的窗口
-            QString pathMessage = QString("路径：%1").arg(QString::fromStdString(join(path2, " -> ")));
+            QString pathMessage = QString("路径：%1").arg(QString::fromStdString(path2.join(" -> ")));
+            pathMessage += "\n" + queryStatistics(Engine::Sequential, key);
             QWidget* pathWindow = new QWidget(nullptr);
             pathWindow->setWindowTitle("顺序搜索路径");
             QVBoxLayout* pathLayout = new QVBoxLayout(pathWindow);
@@ -524,19 +303,45 @@ void MainWindow::on_buttonClicked() {
             pathWindow->show();
 
             QMessageBox::information(this, "翻译为",
-                                     QString::fromStdString(meaning2));});
+                                     QString::fromUtf8(meaning2.data(), int(meaning2.size())));
 
             // 显示时间
-            QString timeMessage = QString("查询耗时: %1 毫秒").arg(elapsedTime.count());
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
+            QMessageBox::information(this, "查询耗时", timeMessage);
+
+        }
+        else if (messageBox.clickedButton() == btnSorted) {
+            elapsedTime = measureExecutionTime([&]() { m_index->searchSorted(key, path6, meaning6); });
+            QString message = QString("路径：%1\n解释：%2")
+                                  .arg(QString::fromStdString(path6.join(" -> ")))
+                                  .arg(QString::fromUtf8(meaning6.data(), int(meaning6.size())));
+            message += "\n" + queryStatistics(Engine::SortedArray, key);
+
+            QWidget* messageWindow = new QWidget(nullptr);
+            messageWindow->setWindowTitle("二分查找路径");
+            QVBoxLayout* layout = new QVBoxLayout(messageWindow);
+            //垂直布局
+            QTextEdit* textEdit = new QTextEdit(messageWindow);
+            textEdit->setText(message);
+            textEdit->setReadOnly(true);
+            layout->addWidget(textEdit);
+
+            messageWindow->resize(400, 300);
+            messageWindow->show();
+            QMessageBox::information(this, "翻译为",
+                                     QString::fromUtf8(meaning6.data(), int(meaning6.size())));
+
+            // 显示时间
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
             QMessageBox::information(this, "查询耗时", timeMessage);
 
         }
         else if (messageBox.clickedButton() == btnAVL) {
-            elapsedTime = measureExecutionTime([&]() {
-            searchAVL(avlMap[firstChar], key, path3, meaning3);
+            elapsedTime = measureExecutionTime([&]() { m_index->searchAVL(m_index->avlRoot(firstChar), key, path3, meaning3); });
             QString message = QString("路径：%1\n解释：%2")
-                                  .arg(QString::fromStdString(join(path3, " -> ")))
-                                  .arg(QString::fromStdString(meaning3));
+                                  .arg(QString::fromStdString(path3.join(" -> ")))
+                                  .arg(QString::fromUtf8(meaning3.data(), int(meaning3.size())));
+            message += "\n" + queryStatistics(Engine::AVL, key);
 
             QWidget* messageWindow = new QWidget(nullptr);
             messageWindow->setWindowTitle("查询结果");
@@ -550,18 +355,42 @@ void MainWindow::on_buttonClicked() {
             messageWindow->resize(400, 300);
             messageWindow->show();
             QMessageBox::information(this, "翻译为",
-                                     QString::fromStdString(meaning3));});
+                                     QString::fromUtf8(meaning3.data(), int(meaning3.size())));
 
             // 显示时间
-            QString timeMessage = QString("查询耗时: %1 毫秒").arg(elapsedTime.count());
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
             QMessageBox::information(this, "查询耗时", timeMessage);
 
         } else if (messageBox.clickedButton() == btnRB) {
-            elapsedTime = measureExecutionTime([&]() {
-            searchRB(rbMap[firstChar], key, path4, meaning4);
+            elapsedTime = measureExecutionTime([&]() { m_index->searchRB(m_index->rbRoot(firstChar), key, path4, meaning4); });
+            QString message = QString("路径：%1\n解释：%2")
+                                  .arg(QString::fromStdString(path4.join(" -> ")))
+                                  .arg(QString::fromUtf8(meaning4.data(), int(meaning4.size())));
+            message += "\n" + queryStatistics(Engine::RB, key);
+
+            QWidget* messageWindow = new QWidget(nullptr);
+            messageWindow->setWindowTitle("查询结果");
+            QVBoxLayout* layout = new QVBoxLayout(messageWindow);
+            //垂直布局
+            QTextEdit* textEdit = new QTextEdit(messageWindow);
+            textEdit->setText(message);
+            textEdit->setReadOnly(true);
+            layout->addWidget(textEdit);
+
+            messageWindow->resize(400, 300);
+            messageWindow->show();
+            QMessageBox::information(this, "翻译为",
+                                     QString::fromUtf8(meaning4.data(), int(meaning4.size())));
+
+            // 显示时间
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
+            QMessageBox::information(this, "查询耗时", timeMessage);
+        } else if (messageBox.clickedButton() == btnEytzinger) {
+            elapsedTime = measureExecutionTime([&]() { m_index->searchEytzinger(key, path5, meaning5); });
             QString message = QString("路径：%1\n解释：%2")
-                                  .arg(QString::fromStdString(join(path4, " -> ")))
-                                  .arg(QString::fromStdString(meaning4));
+                                  .arg(QString::fromStdString(path5.join(" -> ")))
+                                  .arg(QString::fromUtf8(meaning5.data(), int(meaning5.size())));
+            message += "\n" + queryStatistics(Engine::Eytzinger, key);
 
             QWidget* messageWindow = new QWidget(nullptr);
             messageWindow->setWindowTitle("查询结果");
@@ -575,13 +404,22 @@ void MainWindow::on_buttonClicked() {
             messageWindow->resize(400, 300);
             messageWindow->show();
             QMessageBox::information(this, "翻译为",
-                                     QString::fromStdString(meaning4));});
+                                     QString::fromUtf8(meaning5.data(), int(meaning5.size())));
 
             // 显示时间
-            QString timeMessage = QString("查询耗时: %1 毫秒").arg(elapsedTime.count());
+            QString timeMessage = QString("查询耗时: %1 微秒").arg(elapsedTime.count(), 0, 'f', 2);
             QMessageBox::information(this, "查询耗时", timeMessage);
         }
     } else {
-        QMessageBox::warning(this, "未找到", "未找到该单词！");
+        // 基数树就绪后给出拼写相近的单词
+        vector<string> corrections;
+        if (m_index->isReady(Engine::Trie)) corrections = m_index->suggestCorrections(key);
+        QString message = "未找到该单词！";
+        if (!corrections.empty()) {
+            QStringList words;
+            for (const auto& word : corrections) words.append(QString::fromStdString(word));
+            message += QString("\n您是不是要找：%1").arg(words.join("，"));
+        }
+        QMessageBox::warning(this, "未找到", message);
     }
 }
@@ -5,43 +5,18 @@
 #include <QLineEdit>
 #include <QListWidget>
 #include <QPushButton>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
 #include <vector>
 #include <string>
-#include <map>
+#include <memory>
 #include <chrono>
+#include "dictionaryindex.h"
 using namespace std;
 
-// 二叉搜索树节点
-struct BSTNode {
-    string key;
-    string value;
-    BSTNode* left;
-    BSTNode* right;
-    BSTNode(const string& k, const string& v) : key(k), value(v), left(nullptr), right(nullptr) {}
-};
-
-
-// AVL树节点
-struct AVLNode {
-    string key;
-    string value;
-    AVLNode* left;
-    AVLNode* right;
-    int height; // 平衡因子
-
-    AVLNode(const string& k, const string& v) : key(k), value(v), left(nullptr), right(nullptr), height(1) {}
-};
-
-// 红黑树节点
-struct RBNode {
-    string key;
-    string value;
-    RBNode* left;
-    RBNode* right;
-    RBNode* parent;
-    bool isRed; // 红黑标志
-    RBNode(const string& k, const string& v) : key(k), value(v), left(nullptr), right(nullptr), parent(nullptr), isRed(true) {}
-};
+class DictionaryLoader;
+class SuggestionWorker;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -52,48 +27,41 @@ public:
 private slots:
     void on_lineEdit_textChanged(const QString& text);
     void on_buttonClicked();
+    void onLoadProgress(int percent, const QString& stage);
+    void onEngineReady(int engine);
+    void onLoadFailed(const QString& message);
+    void requestSuggestions();
+    void onSuggestionsReady(quint64 generation, const QStringList& words, double searchMicros);
+    void onSuggestionsAppended(quint64 generation, const QStringList& words);
+    // 诊断菜单：各树引擎首字母分片的高度、深度分布、期望比较次数和红黑树的黑高
+    void showTreeStatistics();
+    // 诊断菜单：各引擎的节点、分配器开销、分片表和引用的字符串
+    void showMemoryUsage();
 
 private:
+    // 结果窗口中的查找统计：比较次数、访问的节点数、比较的字节数；
+    // 设置 DICT_PERF 时另用硬件计数器测一次不记录路径的查找
+    QString queryStatistics(Engine engine, const string& key) const;
+    // 诊断信息的窗口，等宽字体，关闭时释放
+    void showDiagnostics(const QString& title, const QString& text);
+
     QLineEdit* lineEdit;
     QListWidget* listWidget;
     QPushButton* searchButton;
-
-    // 数据存储
-   vector<pair<string, string>> m_allWords; // 顺序查找
-   map<char, BSTNode*> bstMap; // 依照首字母建立二叉树
-   map<char, AVLNode*> avlMap;  // AVL 树
-   map<char, RBNode*> rbMap; // 红黑树
-
-    void loadDictionary(const QString& fileName);
-    vector<string> prefixSearchSequential(const string& prefix, int maxResults = 10); //按序查找
-    vector<string> prefixSearchBST(BSTNode* root, const std::string& prefix, int maxResults = 10);
-    vector<string> prefixSearchAVL(AVLNode* root, const string& prefix, int maxResults = 10);
-
-    BSTNode* insertBST(BSTNode* root, const string& key, const string& value);
-    AVLNode* insertAVL(AVLNode* root, const string& key, const string& value);
-    RBNode* insertRB(RBNode* root, const string& key, const string& value);
-
-    bool searchBST(BSTNode* root, const string& key, vector<string>& path, string& result);
-    bool sequentialSearch(const string& key, vector<std::string>& path, std::string& result);
-    bool searchAVL(AVLNode* root, const string& key, vector<string>& path, string& result);
-     bool searchRB(RBNode* root, const string& key, vector<string>& path, string& result);
-
-    void deleteBST(BSTNode* root);
-    void deleteAllBSTs();
-    void deleteAVL(AVLNode* root);
-    void deleteAllAVLs();
-    void deleteRB(RBNode* root);
-    void deleteAllRBs();
-
-    int compareKeys(const string& a, const string& b);
-    // AVL 树的旋转
-    AVLNode* rotateLeft(AVLNode* x);
-    AVLNode* rotateRight(AVLNode* y);
-    int getHeight(AVLNode* node);
-    int getBalance(AVLNode* node);
-    RBNode*fixInsertRB(RBNode* root, RBNode* node) ;
-    RBNode*leftRotateRB(RBNode* root, RBNode* node);
-    RBNode* rightRotateRB(RBNode* root, RBNode* node);
+    QProgressBar* progressBar;
+
+    // 数据存储，由后台线程逐个引擎建立
+    shared_ptr<DictionaryIndex> m_index;
+    QThread m_loaderThread;
+    DictionaryLoader* m_loader;
+
+    // 输入联想在自己的线程中进行；输入停顿 kSuggestDebounceMs 后才发出请求
+    static constexpr int kSuggestDebounceMs = 30;
+    QThread m_suggestThread;
+    SuggestionWorker* m_suggester;
+    QTimer m_suggestTimer;
+    quint64 m_suggestGeneration = 0;
+    chrono::steady_clock::time_point m_keystrokeTime; // 最近一次输入的时刻，用于统计输入到显示的延迟
 };
 
 #endif
@@ -0,0 +1,30 @@
+#include "mappedfile.h"
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const QString& fileName) {
+    close();
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    qint64 fileSize = m_file.size();
+    if (fileSize == 0) return true; // 空文件无法映射，按零长度处理
+
+    uchar* mapped = m_file.map(0, fileSize);
+    if (!mapped) {
+        m_file.close();
+        return false;
+    }
+    m_data = reinterpret_cast<const char*>(mapped);
+    m_size = static_cast<size_t>(fileSize);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+    m_data = nullptr;
+    m_size = 0;
+    if (m_file.isOpen()) m_file.close();
+}
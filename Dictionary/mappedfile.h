@@ -0,0 +1,29 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <QFile>
+#include <QString>
+#include <cstddef>
+
+// 只读内存映射文件，映射在对象析构时解除
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const QString& fileName);
+    void close();
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_file.isOpen(); }
+
+private:
+    QFile m_file;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+#endif
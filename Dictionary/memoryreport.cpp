@@ -0,0 +1,56 @@
+#include "memoryreport.h"
+#include "memoryusage.h"
+#include <QStringList>
+
+static QString kilobytes(size_t bytes) {
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+QString engineMemoryReport(const DictionaryIndex& index) {
+    QStringList lines;
+    size_t engineTotal = 0;
+    for (Engine engine : {Engine::Sequential, Engine::SortedArray, Engine::BST, Engine::AVL, Engine::RB,
+                          Engine::Eytzinger, Engine::Trie, Engine::Fuzzy, Engine::Reverse, Engine::Suffix}) {
+        if (!index.isReady(engine)) {
+            lines.append(QString("%1：尚未就绪").arg(engineName(engine)));
+            continue;
+        }
+        EngineMemory memory = index.memoryUsage(engine);
+        if (engine == Engine::SortedArray) {
+            lines.append(QString("%1：与顺序查找共用词表，不另占内存").arg(engineName(engine)));
+            continue;
+        }
+        engineTotal += memory.total();
+        lines.append(QString("%1：合计 %2").arg(engineName(engine)).arg(kilobytes(memory.total())));
+        if (memory.viewBytes == 0) {
+            lines.append(QString("  索引结构 %1（按容量计）").arg(kilobytes(memory.structureBytes)));
+            continue;
+        }
+        lines.append(QString("  节点或表项 %1，其中 string_view %2")
+                         .arg(kilobytes(memory.structureBytes))
+                         .arg(kilobytes(memory.viewBytes)));
+        lines.append(QString("  分配器开销 %1（%2 次堆分配）")
+                         .arg(kilobytes(memory.allocatorOverhead))
+                         .arg(memory.allocations));
+        if (memory.shardMapBytes > 0) lines.append(QString("  首字母分片表 %1").arg(kilobytes(memory.shardMapBytes)));
+        lines.append(QString("  引用字符串 %1（在共用的字符串池中，不计入合计）")
+                         .arg(kilobytes(memory.referencedStringBytes)));
+        lines.append(QString("  若各存一份 std::string：%1 个放在对象内部，%2 个另占堆内存共 %3")
+                         .arg(memory.inlineStrings)
+                         .arg(memory.heapStrings)
+                         .arg(kilobytes(memory.heapStringBytes)));
+    }
+
+    const StringPool& pool = index.strings();
+    lines.append(QString());
+    lines.append(QString("各引擎合计 %1").arg(kilobytes(engineTotal)));
+    lines.append(QString("共用：字符串池 %1（拷贝，%2 次分配）+ %3（映射的快照），规范化键 %4")
+                     .arg(kilobytes(pool.ownedBytes()))
+                     .arg(pool.allocations())
+                     .arg(kilobytes(pool.mappedBytes()))
+                     .arg(kilobytes(index.normalizedKeys().memoryBytes())));
+    lines.append(QString("进程常驻内存 %1 MB，峰值 %2 MB")
+                     .arg(currentResidentBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+                     .arg(peakResidentBytes() / (1024.0 * 1024.0), 0, 'f', 1));
+    return lines.join("\n");
+}
@@ -0,0 +1,10 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include "dictionaryindex.h"
+#include <QString>
+
+// 已就绪的各引擎的内存明细（见 EngineMemory），以及各引擎共用的字符串池和规范化键；界面的诊断菜单使用
+QString engineMemoryReport(const DictionaryIndex& index);
+
+#endif
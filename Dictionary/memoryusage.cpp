@@ -0,0 +1,70 @@
+#include "memoryusage.h"
+#include <QtGlobal>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+// /proc/self/status 中以 field 开头的一行，单位 KB
+static size_t statusKilobytes(const char* field) {
+    FILE* status = fopen("/proc/self/status", "r");
+    if (!status) return 0;
+    char line[256];
+    size_t length = strlen(field);
+    size_t kilobytes = 0;
+    while (fgets(line, sizeof(line), status)) {
+        if (strncmp(line, field, length) == 0) {
+            kilobytes = strtoull(line + length, nullptr, 10);
+            break;
+        }
+    }
+    fclose(status);
+    return kilobytes;
+}
+#endif
+
+size_t peakResidentBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    // VmHWM 是常驻内存的最高水位
+    return statusKilobytes("VmHWM:") * 1024;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(Q_OS_MACOS)
+    return usage.ru_maxrss; // macOS 上单位是字节
+#else
+    return usage.ru_maxrss * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+size_t currentResidentBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    return statusKilobytes("VmRSS:") * 1024;
+#else
+    // 其他 Unix 上 getrusage 只给出峰值
+    return 0;
+#endif
+}
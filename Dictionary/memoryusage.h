@@ -0,0 +1,11 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <cstddef>
+
+// 进程的峰值常驻内存（字节），平台不支持时返回 0
+size_t peakResidentBytes();
+// 当前的常驻内存（字节），可以在释放之后回落；平台不支持时返回 0
+size_t currentResidentBytes();
+
+#endif
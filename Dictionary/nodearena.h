@@ -0,0 +1,111 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// 分配统计，用于和逐个 new 的方式对比
+struct ArenaStats {
+    size_t nodes = 0;       // 已分配的节点数
+    size_t allocations = 0; // 实际向堆申请的次数
+    size_t bytes = 0;       // 向堆申请的字节数（不含字符串自身的堆内存）
+};
+
+// 同一种节点的分块分配器：节点从大块中顺序切出，只能整体释放。
+// 节点可平凡析构时释放只需归还各个块，否则逐块调用析构函数（不递归）。
+// 定义 DICT_HEAP_NODES 时退化为每个节点单独 new，便于对比两种方式
+template<typename T>
+class NodeArena {
+public:
+    static const size_t kBlockNodes = 4096;
+
+    NodeArena() = default;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    NodeArena(NodeArena&& other) noexcept { swap(m_blocks, other.m_blocks); swap(m_nodes, other.m_nodes); }
+    NodeArena& operator=(NodeArena&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(m_blocks, other.m_blocks);
+            swap(m_nodes, other.m_nodes);
+        }
+        return *this;
+    }
+    ~NodeArena() { release(); }
+
+    // 保证接下来的 count 个节点落在同一块中
+    void reserve(size_t count) {
+#ifndef DICT_HEAP_NODES
+        if (m_blocks.empty() || m_blocks.back().capacity - m_blocks.back().used < count) addBlock(count);
+#else
+        (void)count;
+#endif
+    }
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+#ifndef DICT_HEAP_NODES
+        if (m_blocks.empty() || m_blocks.back().used == m_blocks.back().capacity) addBlock(kBlockNodes);
+        Block& block = m_blocks.back();
+        T* node = new (block.nodes + block.used) T(std::forward<Args>(args)...);
+        ++block.used;
+#else
+        T* node = new T(std::forward<Args>(args)...);
+        m_blocks.push_back({node, 1, 1});
+#endif
+        ++m_nodes;
+        return node;
+    }
+
+    // 接管另一个分配器的全部节点（并行建树时每个分片各用一个，最后并入引擎）
+    void adopt(NodeArena&& other) {
+        m_blocks.insert(m_blocks.end(), other.m_blocks.begin(), other.m_blocks.end());
+        m_nodes += other.m_nodes;
+        other.m_blocks.clear();
+        other.m_nodes = 0;
+    }
+
+    void release() {
+        for (Block& block : m_blocks) {
+#ifndef DICT_HEAP_NODES
+            if constexpr (!is_trivially_destructible_v<T>) {
+                for (size_t i = 0; i < block.used; ++i) block.nodes[i].~T();
+            }
+            ::operator delete(block.nodes);
+#else
+            delete block.nodes;
+#endif
+        }
+        m_blocks.clear();
+        m_nodes = 0;
+    }
+
+    ArenaStats stats() const {
+        ArenaStats s;
+        s.nodes = m_nodes;
+        s.allocations = m_blocks.size();
+        for (const Block& block : m_blocks) s.bytes += block.capacity * sizeof(T);
+        return s;
+    }
+
+private:
+    struct Block {
+        T* nodes;
+        size_t capacity;
+        size_t used;
+    };
+
+    void addBlock(size_t capacity) {
+        T* nodes = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        m_blocks.push_back({nodes, capacity, 0});
+    }
+
+    vector<Block> m_blocks;
+    size_t m_nodes = 0;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "normalizedindex.h"
+#include <algorithm>
+#include <cctype>
+
+static bool isAsciiSpaceOrPunct(unsigned char c) {
+    return c < 0x80 && (isspace(c) || ispunct(c));
+}
+
+string normalizeKey(string_view word) {
+    size_t begin = 0;
+    size_t end = word.size();
+    while (begin < end && isAsciiSpaceOrPunct(static_cast<unsigned char>(word[begin]))) ++begin;
+    while (end > begin && isAsciiSpaceOrPunct(static_cast<unsigned char>(word[end - 1]))) --end;
+    string key(word.substr(begin, end - begin));
+    for (char& c : key) {
+        if (c >= 'A' && c <= 'Z') c = char(c - 'A' + 'a');
+    }
+    return key;
+}
+
+void NormalizedIndex::build(const vector<pair<string_view, string_view>>& words) {
+    m_keys.clear();
+    m_text.clear();
+    m_keyCount = 0;
+    m_rewritten = 0;
+
+    // 先算出全部规范键，再一次性放进 m_text，之后 m_text 不再扩容，视图保持有效
+    vector<string> normalized(words.size());
+    size_t textBytes = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        normalized[i] = normalizeKey(words[i].first);
+        if (normalized[i] != words[i].first) textBytes += normalized[i].size();
+    }
+    m_text.reserve(textBytes);
+    m_keys.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (normalized[i].empty()) continue;
+        string_view key = words[i].first;
+        if (normalized[i] != key) {
+            key = string_view(m_text.data() + m_text.size(), normalized[i].size());
+            m_text += normalized[i];
+        }
+        m_keys.push_back({key, words[i].first, static_cast<uint32_t>(i)});
+    }
+
+    // 同一规范键的写法排在一起，原词就是规范键的排最前，其次按词表顺序；每组的第一个即规范词条
+    stable_sort(m_keys.begin(), m_keys.end(), [](const Key& a, const Key& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.word == a.key && b.word != b.key;
+    });
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        if (i > 0 && m_keys[i - 1].key == m_keys[i].key) continue;
+        ++m_keyCount;
+        if (m_keys[i].word != m_keys[i].key) ++m_rewritten;
+    }
+}
+
+uint32_t NormalizedIndex::find(string_view query) const {
+    string key = normalizeKey(query);
+    auto it = lower_bound(m_keys.begin(), m_keys.end(), key,
+                          [](const Key& k, const string& q) { return k.key < q; });
+    if (it == m_keys.end() || it->key != key) return kNotFound;
+    // 同一规范键的写法通常只有一两个，顺着往后找原样的写法，找不到就用规范词条
+    for (auto variant = it; variant != m_keys.end() && variant->key == key; ++variant) {
+        if (variant->word == query) return variant->entry;
+    }
+    return it->entry;
+}
@@ -0,0 +1,44 @@
+#ifndef NORMALIZEDINDEX_H
+#define NORMALIZEDINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 规范化的键：ASCII 字母转小写，去掉首尾的空白和标点，中间的连字符、撇号等保留
+string normalizeKey(string_view word);
+
+// 规范化键到规范词条的映射。"Apple"、"apple"、" apple." 这些写法规范化后相同，
+// 都对应同一个词条：有与规范键完全相同的单词时取它，否则取词表中的第一个写法。
+// 同一规范键的各个写法都留在表里，输入原样是其中一个写法时取它本身，
+// 查询时先把输入规范化再二分查找一次，不必再按不同大小写各查一次
+class NormalizedIndex {
+public:
+    static const uint32_t kNotFound = UINT32_MAX;
+
+    // words 必须按单词排好序，并在本索引的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words);
+
+    // query 原样在词表中时返回它的下标，否则返回规范词条的下标，都没有时返回 kNotFound
+    uint32_t find(string_view query) const;
+
+    size_t size() const { return m_keyCount; } // 不同规范键的个数
+    size_t rewrittenCount() const { return m_rewritten; } // 规范键与原词不同的个数
+    size_t memoryBytes() const { return m_keys.capacity() * sizeof(Key) + m_text.capacity(); }
+
+private:
+    struct Key {
+        string_view key;  // 与原词相同时直接指向原词，否则指向 m_text
+        string_view word; // 原词
+        uint32_t entry;
+    };
+
+    vector<Key> m_keys; // 按规范键排序，同一键的写法中规范词条排最前
+    string m_text;
+    size_t m_keyCount = 0;
+    size_t m_rewritten = 0;
+};
+
+#endif
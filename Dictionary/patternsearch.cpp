@@ -0,0 +1,65 @@
+#include "patternsearch.h"
+#include "stringkernels.h"
+#include <algorithm>
+
+WildcardPattern::WildcardPattern(string_view pattern) : m_pattern(pattern), m_length(pattern.size()) {
+    if (!isValid()) return;
+    for (size_t i = 0; i < m_length; ++i) {
+        State bit = State(1) << i;
+        unsigned char c = static_cast<unsigned char>(pattern[i]);
+        if (c == '*') {
+            m_starMask |= bit;
+        } else if (c == '?') {
+            for (State& mask : m_byteMask) mask |= bit;
+        } else {
+            m_byteMask[c] |= bit;
+        }
+    }
+    m_acceptMask = State(1) << m_length;
+    m_start = closure(1);
+}
+
+bool WildcardPattern::matches(string_view word) const {
+    if (!isValid()) return false;
+    State state = m_start;
+    for (size_t i = 0; i < word.size() && state; ++i) state = step(state, static_cast<unsigned char>(word[i]));
+    return accepts(state);
+}
+
+string_view WildcardPattern::trailingLiteral() const {
+    size_t last = m_pattern.find_last_of("?*");
+    if (last == string::npos) return m_pattern;
+    return string_view(m_pattern).substr(last + 1);
+}
+
+void ReversedKeyIndex::build(const vector<pair<string_view, string_view>>& words) {
+    m_keys.clear();
+    m_text.clear();
+
+    // 先一次性分配 m_text，之后不再扩容，视图保持有效
+    size_t textBytes = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (i == 0 || words[i].first != words[i - 1].first) textBytes += words[i].first.size();
+    }
+    m_text.reserve(textBytes);
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (i > 0 && words[i].first == words[i - 1].first) continue;
+        string_view word = words[i].first;
+        string_view reversed(m_text.data() + m_text.size(), word.size());
+        m_text.append(word.rbegin(), word.rend());
+        m_keys.push_back({reversed, static_cast<uint32_t>(i)});
+    }
+    sort(m_keys.begin(), m_keys.end(), [](const Key& a, const Key& b) {
+        return compareBytes(a.reversed, b.reversed) < 0;
+    });
+    m_keys.shrink_to_fit();
+}
+
+void ReversedKeyIndex::forEachWithSuffix(string_view suffix, const function<bool(uint32_t)>& onMatch) const {
+    string reversed(suffix.rbegin(), suffix.rend());
+    auto it = lower_bound(m_keys.begin(), m_keys.end(), reversed,
+                          [](const Key& key, const string& r) { return compareBytes(key.reversed, r) < 0; });
+    for (; it != m_keys.end() && startsWith(it->reversed, reversed); ++it) {
+        if (!onMatch(it->entry)) return;
+    }
+}
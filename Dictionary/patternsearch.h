@@ -0,0 +1,82 @@
+#ifndef PATTERNSEARCH_H
+#define PATTERNSEARCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// 通配符查找的公共部分。? 匹配任意一个字节，* 匹配任意多个字节（含零个），其余字节按原样匹配
+
+// 模式编译成位并行的状态机：第 i 位表示已匹配模式的前 i 个字节。
+// 状态可以逐字节推进，所以能沿基数树向下走，同一前缀的单词共用推进的结果
+class WildcardPattern {
+public:
+    using State = uint64_t;
+    static const size_t kMaxLength = 63;
+    // 查找时每访问这么多个节点或候选询问一次是否停止；匹配很少的模式也能及时取消
+    static const size_t kStopInterval = 1024;
+
+    explicit WildcardPattern(string_view pattern);
+
+    static bool hasWildcard(string_view text) { return text.find_first_of("?*") != string_view::npos; }
+    bool isValid() const { return m_length <= kMaxLength; }
+
+    State start() const { return m_start; }
+    // 0 表示不可能再匹配，可以剪掉
+    State step(State state, unsigned char c) const {
+        return closure(((state & m_byteMask[c]) << 1) | (state & m_starMask));
+    }
+    bool accepts(State state) const { return state & m_acceptMask; }
+    bool matches(string_view word) const;
+
+    bool leadingStar() const { return m_length > 0 && m_pattern[0] == '*'; }
+    // 最后一个通配符之后的字面后缀，模式以通配符结尾时为空
+    string_view trailingLiteral() const;
+
+private:
+    // 位于 * 上的状态也可以跳过这个 *
+    State closure(State state) const {
+        State previous;
+        do {
+            previous = state;
+            state |= (state & m_starMask) << 1;
+        } while (state != previous);
+        return state;
+    }
+
+    string m_pattern;
+    size_t m_length;
+    State m_byteMask[256] = {}; // 第 i 位：模式第 i 个字节是该字节或 ?
+    State m_starMask = 0;
+    State m_acceptMask = 0;
+    State m_start = 0;
+};
+
+// 反转键索引：把每个单词倒过来排序，后缀查找变成反转键上的前缀查找，
+// 用于 *tion 这样以 * 开头、基数树无从剪枝的模式
+class ReversedKeyIndex {
+public:
+    // words 必须按单词排好序（允许重复，重复的取第一条），并在本索引的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words);
+
+    // 依次给出以 suffix 结尾的单词的词表下标，按反转键的顺序；onMatch 返回 false 时停止
+    void forEachWithSuffix(string_view suffix, const function<bool(uint32_t)>& onMatch) const;
+
+    size_t size() const { return m_keys.size(); }
+    size_t memoryBytes() const { return m_keys.capacity() * sizeof(Key) + m_text.capacity(); }
+
+private:
+    struct Key {
+        string_view reversed; // 指向 m_text
+        uint32_t entry;
+    };
+
+    vector<Key> m_keys; // 按反转键排序
+    string m_text;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "perfcounter.h"
+#include <QtGlobal>
+
+#if defined(Q_OS_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+PerfCounter::PerfCounter(Event event) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    switch (event) {
+    case Cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case Instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case LlcMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case DtlbMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    }
+    m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounter::~PerfCounter() {
+    if (m_fd >= 0) close(m_fd);
+}
+
+void PerfCounter::start() {
+    if (m_fd < 0) return;
+    ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t PerfCounter::stop() {
+    if (m_fd < 0) return 0;
+    ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t count = 0;
+    if (read(m_fd, &count, sizeof(count)) != sizeof(count)) return 0;
+    return count;
+}
+
+#else
+
+PerfCounter::PerfCounter(Event) {}
+PerfCounter::~PerfCounter() {}
+void PerfCounter::start() {}
+uint64_t PerfCounter::stop() { return 0; }
+
+#endif
+
+bool HardwareCounters::isValid(PerfCounter::Event event) const {
+    switch (event) {
+    case PerfCounter::Cycles: return m_cycles.isValid();
+    case PerfCounter::Instructions: return m_instructions.isValid();
+    case PerfCounter::LlcMisses: return m_llcMisses.isValid();
+    case PerfCounter::DtlbMisses: return m_dtlbMisses.isValid();
+    }
+    return false;
+}
+
+// 周期和指令放在最内层，其他计数器开关时的用户态指令不计入
+void HardwareCounters::start() {
+    m_dtlbMisses.start();
+    m_llcMisses.start();
+    m_instructions.start();
+    m_cycles.start();
+}
+
+HardwareCounters::Counts HardwareCounters::stop() {
+    Counts counts;
+    counts.cycles = m_cycles.stop();
+    counts.instructions = m_instructions.stop();
+    counts.llcMisses = m_llcMisses.stop();
+    counts.dtlbMisses = m_dtlbMisses.stop();
+    return counts;
+}
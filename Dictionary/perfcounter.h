@@ -0,0 +1,48 @@
+#ifndef PERFCOUNTER_H
+#define PERFCOUNTER_H
+
+#include <cstdint>
+
+// 硬件性能计数器（Linux perf_event_open，只统计本线程的用户态事件）。
+// 其他平台或没有权限时 isValid() 为 false，读数恒为 0
+class PerfCounter {
+public:
+    enum Event { Cycles, Instructions, LlcMisses, DtlbMisses }; // dTLB 只统计读未命中
+
+    explicit PerfCounter(Event event);
+    ~PerfCounter();
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool isValid() const { return m_fd >= 0; }
+    void start();
+    uint64_t stop(); // 返回 start 以来的事件数
+
+private:
+    int m_fd = -1;
+};
+
+// 一次打开周期、指令、末级缓存未命中和 dTLB 未命中四个计数器，一起开始和停止。
+// 各事件独立打开，某个事件不受支持时它的读数为 0，不影响其他事件
+class HardwareCounters {
+public:
+    struct Counts {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t llcMisses = 0;
+        uint64_t dtlbMisses = 0;
+    };
+
+    bool isValid() const { return m_cycles.isValid() || m_instructions.isValid(); }
+    bool isValid(PerfCounter::Event event) const;
+    void start();
+    Counts stop();
+
+private:
+    PerfCounter m_cycles{PerfCounter::Cycles};
+    PerfCounter m_instructions{PerfCounter::Instructions};
+    PerfCounter m_llcMisses{PerfCounter::LlcMisses};
+    PerfCounter m_dtlbMisses{PerfCounter::DtlbMisses};
+};
+
+#endif
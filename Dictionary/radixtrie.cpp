@@ -0,0 +1,237 @@
+#include "radixtrie.h"
+#include "stringkernels.h"
+#include <algorithm>
+
+void RadixTrie::build(const vector<pair<string_view, string_view>>& words) {
+    m_words = &words;
+    m_nodes.clear();
+    m_firstBytes.clear();
+    m_nodes.reserve(words.size() * 2);
+    m_firstBytes.reserve(words.size() * 2);
+    m_nodes.push_back({nullptr, 0, 0, 0, kNoEntry});
+    m_firstBytes.push_back(0);
+    if (!words.empty()) buildNode(0, 0, words.size(), 0);
+    m_nodes.shrink_to_fit();
+    m_firstBytes.shrink_to_fit();
+    m_rankOffset.clear();
+    m_ranked.clear();
+    m_rankLimit = 0;
+}
+
+// [begin, end) 中的单词前 depth 个字节相同。有序区间的公共前缀就是首尾两个单词的公共前缀。
+// 根节点没有标签，查找从第 0 个字节起按子节点走，所以根不取公共前缀：
+// 全部单词同一前缀（或只有一个单词）时，前缀放在根唯一的子节点的标签上
+void RadixTrie::buildNode(uint32_t index, size_t begin, size_t end, size_t depth) {
+    const auto& words = *m_words;
+    string_view first = words[begin].first;
+    string_view last = words[end - 1].first;
+    size_t common = depth;
+    size_t limit = index == 0 ? depth : min(first.size(), last.size());
+    while (common < limit && first[common] == last[common]) ++common;
+
+    // 根节点没有标签；其他节点的标签是公共前缀中 depth 之后的部分
+    if (index != 0) {
+        m_nodes[index].label = first.data() + depth;
+        m_nodes[index].labelLength = static_cast<uint32_t>(common - depth);
+    }
+    if (first.size() == common) {
+        m_nodes[index].entry = static_cast<uint32_t>(begin);
+        while (begin < end && words[begin].first.size() == common) ++begin; // 跳过重复单词
+    }
+    if (begin == end) return;
+
+    // 按第 common 个字节分组，每组一个子节点；先连续分配全部子节点，再逐个向下建
+    vector<size_t> groups{begin};
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (words[i].first[common] != words[i - 1].first[common]) groups.push_back(i);
+    }
+    groups.push_back(end);
+
+    uint32_t firstChild = static_cast<uint32_t>(m_nodes.size());
+    uint32_t childCount = static_cast<uint32_t>(groups.size() - 1);
+    m_nodes[index].firstChild = firstChild;
+    m_nodes[index].childCount = childCount;
+    for (uint32_t c = 0; c < childCount; ++c) {
+        m_nodes.push_back({nullptr, 0, 0, 0, kNoEntry});
+        m_firstBytes.push_back(static_cast<unsigned char>(words[groups[c]].first[common]));
+    }
+    for (uint32_t c = 0; c < childCount; ++c) {
+        buildNode(firstChild + c, groups[c], groups[c + 1], common);
+    }
+}
+
+int RadixTrie::findChild(const Node& node, unsigned char c) const {
+    auto begin = m_firstBytes.begin() + node.firstChild;
+    auto end = begin + node.childCount;
+    auto it = lower_bound(begin, end, c);
+    if (it == end || *it != c) return -1;
+    return static_cast<int>(it - m_firstBytes.begin());
+}
+
+vector<string> RadixTrie::prefixSearch(string_view prefix, int maxResults) const {
+    Cursor cursor;
+    if (!advance(cursor, prefix)) return {};
+    return completions(cursor, maxResults);
+}
+
+bool RadixTrie::advance(Cursor& cursor, string_view added) const {
+    if (m_nodes.empty()) cursor.node = kNoNode;
+    if (cursor.node == kNoNode) return false;
+
+    // 先走完当前边上剩下的标签，再逐个子节点向下
+    size_t matched = 0;
+    while (matched < added.size()) {
+        const Node* node = &m_nodes[cursor.node];
+        if (cursor.labelOffset == node->labelLength) {
+            int child = findChild(*node, static_cast<unsigned char>(added[matched]));
+            if (child < 0) {
+                cursor.node = kNoNode;
+                return false;
+            }
+            cursor.node = static_cast<uint32_t>(child);
+            cursor.labelOffset = 0;
+            node = &m_nodes[child];
+        }
+        size_t length = min<size_t>(node->labelLength - cursor.labelOffset, added.size() - matched);
+        if (firstMismatch(node->label + cursor.labelOffset, added.data() + matched, length) != length) {
+            cursor.node = kNoNode;
+            return false;
+        }
+        matched += length;
+        cursor.labelOffset += static_cast<uint32_t>(length);
+    }
+    return true;
+}
+
+vector<string> RadixTrie::completions(const Cursor& cursor, int maxResults) const {
+    vector<string> results;
+    if (cursor.node == kNoNode || m_nodes.empty() || maxResults <= 0) return results;
+    if (maxResults <= m_rankLimit) {
+        size_t end = min(m_rankOffset[cursor.node + 1], m_rankOffset[cursor.node] + size_t(maxResults));
+        for (size_t i = m_rankOffset[cursor.node]; i < end; ++i) results.emplace_back((*m_words)[m_ranked[i]].first);
+        return results;
+    }
+    collect(cursor.node, results, maxResults);
+    return results;
+}
+
+// 子节点的下标总比父节点大，倒序处理时子节点的表已经算好，父节点只需合并子节点的前 k 个
+void RadixTrie::rank(const vector<uint64_t>& frequency, int k) {
+    k = min(k, 255);
+    const size_t nodeCount = m_nodes.size();
+    if (k <= 0 || nodeCount == 0) return;
+    const size_t width = size_t(k);
+    auto better = [&](uint32_t a, uint32_t b) {
+        return frequency[a] != frequency[b] ? frequency[a] > frequency[b] : a < b;
+    };
+
+    // 先按子树中的单词数（不超过 k）算出每个节点的候选数和在表中的偏移，
+    // 再把子节点的候选归并进父节点，直接写进压缩后的表，不另开每节点 k 格的临时表
+    vector<uint8_t> counts(nodeCount);
+    for (size_t i = nodeCount; i-- > 0;) {
+        const Node& node = m_nodes[i];
+        size_t total = node.entry != kNoEntry ? 1 : 0;
+        for (uint32_t c = node.firstChild; c < node.firstChild + node.childCount && total < width; ++c) {
+            total += counts[c];
+        }
+        counts[i] = static_cast<uint8_t>(min(total, width));
+    }
+    m_rankOffset.assign(nodeCount + 1, 0);
+    for (size_t i = 0; i < nodeCount; ++i) m_rankOffset[i + 1] = m_rankOffset[i] + counts[i];
+    m_ranked.assign(m_rankOffset[nodeCount], 0);
+
+    vector<uint32_t> merged;
+    for (size_t i = nodeCount; i-- > 0;) {
+        const Node& node = m_nodes[i];
+        merged.clear();
+        if (node.entry != kNoEntry) merged.push_back(node.entry);
+        for (uint32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+            merged.insert(merged.end(), m_ranked.begin() + m_rankOffset[c], m_ranked.begin() + m_rankOffset[c + 1]);
+        }
+        partial_sort(merged.begin(), merged.begin() + counts[i], merged.end(), better);
+        copy(merged.begin(), merged.begin() + counts[i], m_ranked.begin() + m_rankOffset[i]);
+    }
+    m_rankLimit = k;
+}
+
+// 按字典序先序遍历子树，凑够 maxResults 个即停
+void RadixTrie::collect(uint32_t index, vector<string>& results, int maxResults) const {
+    vector<uint32_t> stack{index};
+    while (!stack.empty() && (int)results.size() < maxResults) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (node.entry != kNoEntry) results.push_back(string((*m_words)[node.entry].first));
+        for (uint32_t c = node.childCount; c > 0; --c) stack.push_back(node.firstChild + c - 1);
+    }
+}
+
+vector<FuzzyMatch> RadixTrie::fuzzySearch(string_view word, int maxDistance) const {
+    vector<FuzzyMatch> matches;
+    if (m_nodes.empty()) return matches;
+    // rows 依次存放深度 0、1、2… 的行，每行 |word| + 1 个数
+    vector<int> rows(word.size() + 1);
+    for (size_t i = 0; i <= word.size(); ++i) rows[i] = min(int(i), maxDistance + 1);
+    fuzzyVisit(0, 0, word, maxDistance, rows, matches);
+    return matches;
+}
+
+void RadixTrie::fuzzyVisit(uint32_t index, size_t depth, string_view word, int maxDistance, vector<int>& rows,
+                           vector<FuzzyMatch>& matches) const {
+    const size_t width = word.size() + 1;
+    const int outside = maxDistance + 1;
+    const Node& node = m_nodes[index];
+    // 逐个处理边上的字符，每个字符在上一行之后追加一行。
+    // 距离不超过 maxDistance 的格子只在对角线两侧 maxDistance 以内，带外的格子记为 outside
+    for (uint32_t c = 0; c < node.labelLength; ++c, ++depth) {
+        if (rows.size() < (depth + 2) * width) rows.resize((depth + 2) * width);
+        const int* previous = &rows[depth * width];
+        int* current = &rows[(depth + 1) * width];
+        const size_t row = depth + 1;
+        size_t low = row > size_t(maxDistance) ? row - maxDistance : 0;
+        size_t high = min(width - 1, row + maxDistance);
+        if (low > high) return;
+        int rowMin = outside;
+        if (low == 0) {
+            current[0] = int(row);
+            rowMin = current[0];
+            low = 1;
+        } else {
+            current[low - 1] = outside;
+        }
+        for (size_t i = low; i <= high; ++i) {
+            int cost = word[i - 1] == node.label[c] ? 0 : 1;
+            current[i] = min({previous[i] + 1, current[i - 1] + 1, previous[i - 1] + cost});
+            rowMin = min(rowMin, current[i]);
+        }
+        if (high + 1 < width) current[high + 1] = outside;
+        if (rowMin > maxDistance) return;
+    }
+    // 最后一格在带外时单词长度差已超过 maxDistance
+    bool inBand = depth <= word.size() + maxDistance && word.size() <= depth + maxDistance;
+    int distance = inBand ? rows[depth * width + word.size()] : outside;
+    if (node.entry != kNoEntry && distance <= maxDistance) matches.push_back({node.entry, distance});
+    for (uint32_t c = 0; c < node.childCount; ++c) {
+        fuzzyVisit(node.firstChild + c, depth, word, maxDistance, rows, matches);
+    }
+}
+
+void RadixTrie::patternSearch(const WildcardPattern& pattern, const function<bool(uint32_t)>& onMatch,
+                              const function<bool()>& shouldStop) const {
+    if (m_nodes.empty() || !pattern.isValid()) return;
+    PatternWalk walk{pattern, onMatch, shouldStop, 0};
+    patternVisit(0, pattern.start(), walk);
+}
+
+bool RadixTrie::patternVisit(uint32_t index, WildcardPattern::State state, PatternWalk& walk) const {
+    if (walk.shouldStop && ++walk.visited % WildcardPattern::kStopInterval == 0 && walk.shouldStop()) return false;
+    const Node& node = m_nodes[index];
+    for (uint32_t c = 0; c < node.labelLength; ++c) {
+        state = walk.pattern.step(state, static_cast<unsigned char>(node.label[c]));
+        if (!state) return true;
+    }
+    if (node.entry != kNoEntry && walk.pattern.accepts(state) && !walk.onMatch(node.entry)) return false;
+    for (uint32_t c = 0; c < node.childCount; ++c) {
+        if (!patternVisit(node.firstChild + c, state, walk)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef RADIXTRIE_H
+#define RADIXTRIE_H
+
+#include "fuzzysearch.h"
+#include "patternsearch.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 路径压缩的基数树，用于输入联想。
+// 所有节点放在一个数组里，同一节点的子节点连续存放并按首字节有序；
+// 边上的标签直接指向字符串池中的单词，不另存字符
+class RadixTrie {
+public:
+    // words 必须按单词排好序（允许重复），并在本树的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words);
+
+    // 前缀在树中停下的位置，可能在某条边的中间。前缀变长时从这里继续向下走，
+    // 只处理新增的字符。前缀走出树之后游标失效，之后再追加字符也不会匹配
+    struct Cursor {
+        uint32_t node = 0;        // 前缀最后一个字符所在边指向的节点，空前缀为根
+        uint32_t labelOffset = 0; // 该边上已匹配的字符数
+    };
+
+    // 返回以 prefix 开头的前 maxResults 个单词（字典序；rank 之后按词频），O(|prefix| + k)
+    vector<string> prefixSearch(string_view prefix, int maxResults = 10) const;
+    // 把游标沿 added 向下移动，O(|added|)；返回前缀是否仍在树中
+    bool advance(Cursor& cursor, string_view added) const;
+    // 游标处子树中的前 maxResults 个单词，O(k)
+    vector<string> completions(const Cursor& cursor, int maxResults = 10) const;
+
+    // 全部与 word 的编辑距离不超过 maxDistance 的单词，按字典序。
+    // 沿树向下逐字符计算编辑距离矩阵的一行，同一前缀的单词共用这些行；
+    // 一行的最小值超过 maxDistance 时整棵子树都不可能匹配，直接剪掉
+    vector<FuzzyMatch> fuzzySearch(string_view word, int maxDistance) const;
+
+    // 按字典序依次给出匹配通配符模式的单词的词表下标；onMatch 返回 false 时停止。
+    // 状态机随边上的字符推进，状态为空时剪掉整棵子树，所以模式以字面字符开头时只走到相应的子树。
+    // shouldStop 非空时每访问 WildcardPattern::kStopInterval 个节点调用一次，返回 true 时停止
+    void patternSearch(const WildcardPattern& pattern, const function<bool(uint32_t)>& onMatch,
+                       const function<bool()>& shouldStop = {}) const;
+
+    // 为每个节点预先算出子树中词频最高的 k 个单词（同频按字典序），frequency 按词表下标给出。
+    // 之后 maxResults 不超过 k 的联想直接返回这张表，不再遍历子树
+    void rank(const vector<uint64_t>& frequency, int k);
+    bool isRanked() const { return m_rankLimit > 0; }
+    size_t rankingBytes() const {
+        return m_rankOffset.capacity() * sizeof(size_t) + m_ranked.capacity() * sizeof(uint32_t);
+    }
+
+    size_t nodeCount() const { return m_nodes.size(); }
+    size_t memoryBytes() const {
+        return m_nodes.capacity() * sizeof(Node) + m_firstBytes.capacity() + rankingBytes();
+    }
+
+private:
+    static const uint32_t kNoEntry = UINT32_MAX;
+    static const uint32_t kNoNode = UINT32_MAX;
+
+    struct Node {
+        const char* label;     // 进入本节点的边上的字符
+        uint32_t labelLength;
+        uint32_t firstChild;   // 子节点在 m_nodes 中的起始下标
+        uint32_t childCount;
+        uint32_t entry;        // 在此结束的单词在词表中的下标
+    };
+
+    void buildNode(uint32_t index, size_t begin, size_t end, size_t depth);
+    int findChild(const Node& node, unsigned char c) const;
+    void collect(uint32_t index, vector<string>& results, int maxResults) const;
+    void fuzzyVisit(uint32_t index, size_t depth, string_view word, int maxDistance, vector<int>& rows,
+                    vector<FuzzyMatch>& matches) const;
+    struct PatternWalk {
+        const WildcardPattern& pattern;
+        const function<bool(uint32_t)>& onMatch;
+        const function<bool()>& shouldStop;
+        size_t visited;
+    };
+    bool patternVisit(uint32_t index, WildcardPattern::State state, PatternWalk& walk) const;
+
+    const vector<pair<string_view, string_view>>* m_words = nullptr;
+    vector<Node> m_nodes;
+    vector<unsigned char> m_firstBytes; // 每个节点标签的首字节，查子节点时不必访问标签
+    // 节点 i 的候选词是 m_ranked[m_rankOffset[i], m_rankOffset[i + 1])，按词频从高到低。
+    // 候选词总数可达节点数的 k 倍，千万条时超过 uint32_t，偏移用 size_t
+    vector<size_t> m_rankOffset;
+    vector<uint32_t> m_ranked;
+    int m_rankLimit = 0;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "reverseindex.h"
+#include <algorithm>
+
+// 解码一个 UTF-8 字符，返回码位并前移 i；非法字节按单字节处理
+static uint32_t nextCodePoint(string_view text, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(text[i++]);
+    if (c < 0x80) return c;
+    int extra = c >= 0xF0 ? 3 : (c >= 0xE0 ? 2 : (c >= 0xC0 ? 1 : 0));
+    uint32_t codePoint = c & (0x3F >> extra);
+    for (int k = 0; k < extra && i < text.size(); ++k) {
+        unsigned char next = static_cast<unsigned char>(text[i]);
+        if ((next & 0xC0) != 0x80) break;
+        codePoint = (codePoint << 6) | (next & 0x3F);
+        ++i;
+    }
+    return codePoint;
+}
+
+// text 中全部单字和相邻非 ASCII 字符的二元组，可能重复
+void ReverseIndex::terms(string_view text, vector<uint64_t>& keys) {
+    uint32_t previous = 0;
+    for (size_t i = 0; i < text.size();) {
+        uint32_t codePoint = nextCodePoint(text, i);
+        if (codePoint < 0x80) {
+            previous = 0;
+            continue;
+        }
+        keys.push_back(codePoint);
+        if (previous) keys.push_back(kBigram | (uint64_t(previous) << 21) | codePoint);
+        previous = codePoint;
+    }
+}
+
+void ReverseIndex::build(const vector<pair<string_view, string_view>>& words) {
+    m_words = &words;
+    m_terms.clear();
+    m_postings.clear();
+    m_postingCount = 0;
+
+    vector<pair<uint64_t, uint32_t>> occurrences;
+    vector<uint64_t> keys;
+    for (size_t i = 0; i < words.size(); ++i) {
+        keys.clear();
+        terms(words[i].second, keys);
+        for (uint64_t key : keys) occurrences.emplace_back(key, static_cast<uint32_t>(i));
+    }
+    sort(occurrences.begin(), occurrences.end());
+    occurrences.erase(unique(occurrences.begin(), occurrences.end()), occurrences.end());
+    m_postingCount = occurrences.size();
+
+    for (size_t i = 0; i < occurrences.size();) {
+        Term term{occurrences[i].first, static_cast<uint32_t>(m_postings.size()), 0};
+        uint32_t last = 0;
+        for (; i < occurrences.size() && occurrences[i].first == term.key; ++i, ++term.count) {
+            uint32_t delta = occurrences[i].second - last;
+            last = occurrences[i].second;
+            while (delta >= 0x80) {
+                m_postings.push_back(static_cast<uint8_t>(delta | 0x80));
+                delta >>= 7;
+            }
+            m_postings.push_back(static_cast<uint8_t>(delta));
+        }
+        m_terms.push_back(term);
+    }
+    m_terms.shrink_to_fit();
+    m_postings.shrink_to_fit();
+}
+
+const ReverseIndex::Term* ReverseIndex::find(uint64_t key) const {
+    auto it = lower_bound(m_terms.begin(), m_terms.end(), key,
+                          [](const Term& term, uint64_t k) { return term.key < k; });
+    return it != m_terms.end() && it->key == key ? &*it : nullptr;
+}
+
+void ReverseIndex::decode(const Term& term, vector<uint32_t>& entries) const {
+    entries.clear();
+    entries.reserve(term.count);
+    const uint8_t* p = m_postings.data() + term.offset;
+    uint32_t entry = 0;
+    for (uint32_t n = 0; n < term.count; ++n) {
+        uint32_t delta = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *p++;
+            delta |= uint32_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        entry += delta;
+        entries.push_back(entry);
+    }
+}
+
+vector<uint32_t> ReverseIndex::search(string_view query, int maxResults) const {
+    vector<uint64_t> keys;
+    terms(query, keys);
+    // 有二元组时只用二元组，单字的倒排表太长
+    if (any_of(keys.begin(), keys.end(), [](uint64_t key) { return key & kBigram; })) {
+        keys.erase(remove_if(keys.begin(), keys.end(), [](uint64_t key) { return !(key & kBigram); }), keys.end());
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    if (keys.empty() || maxResults <= 0) return {};
+
+    vector<const Term*> lists;
+    for (uint64_t key : keys) {
+        const Term* term = find(key);
+        if (!term) return {};
+        lists.push_back(term);
+    }
+    sort(lists.begin(), lists.end(), [](const Term* a, const Term* b) { return a->count < b->count; });
+
+    vector<uint32_t> candidates, next, merged;
+    decode(*lists[0], candidates);
+    for (size_t l = 1; l < lists.size() && !candidates.empty(); ++l) {
+        decode(*lists[l], next);
+        merged.clear();
+        set_intersection(candidates.begin(), candidates.end(), next.begin(), next.end(), back_inserter(merged));
+        candidates.swap(merged);
+    }
+
+    // 二元组都出现不代表它们连在一起，在释义里核对整个查询词
+    const auto& words = *m_words;
+    candidates.erase(remove_if(candidates.begin(), candidates.end(),
+                               [&](uint32_t entry) { return words[entry].second.find(query) == string_view::npos; }),
+                     candidates.end());
+    auto shorter = [&](uint32_t a, uint32_t b) {
+        size_t la = words[a].second.size(), lb = words[b].second.size();
+        return la != lb ? la < lb : a < b;
+    };
+    size_t keep = min(candidates.size(), size_t(maxResults));
+    partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), shorter);
+    candidates.resize(keep);
+    return candidates;
+}
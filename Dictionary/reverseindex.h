@@ -0,0 +1,45 @@
+#ifndef REVERSEINDEX_H
+#define REVERSEINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 释义的倒排索引，用于汉译英。按 UTF-8 解码释义，对每个非 ASCII 字符及相邻两个非 ASCII 字符
+// 组成的二元组记下出现它的词条。倒排表按词表下标递增，存相邻下标的差值，每个差值用变长字节编码。
+// 查询时取查询词的全部二元组（单个字时取该字），从最短的倒排表开始求交集，最后在释义里核对原文
+class ReverseIndex {
+public:
+    // words 必须在本索引的生命周期内保持不变
+    void build(const vector<pair<string_view, string_view>>& words);
+
+    // 释义中含有 query 的词条下标，释义短的在前，最多 maxResults 个
+    vector<uint32_t> search(string_view query, int maxResults = 10) const;
+
+    size_t termCount() const { return m_terms.size(); }
+    size_t postingCount() const { return m_postingCount; }
+    size_t memoryBytes() const { return m_terms.capacity() * sizeof(Term) + m_postings.capacity(); }
+    size_t postingBytes() const { return m_postings.size(); }
+    size_t uncompressedBytes() const { return m_postingCount * sizeof(uint32_t); } // 不压缩时倒排表的大小
+
+private:
+    struct Term {
+        uint64_t key;     // 单字为码位，二元组为 (前一个码位 << 21 | 后一个码位) | kBigram
+        uint32_t offset;  // 在 m_postings 中的起始字节
+        uint32_t count;   // 词条个数
+    };
+    static const uint64_t kBigram = uint64_t(1) << 63;
+
+    static void terms(string_view text, vector<uint64_t>& keys);
+    const Term* find(uint64_t key) const;
+    void decode(const Term& term, vector<uint32_t>& entries) const;
+
+    const vector<pair<string_view, string_view>>* m_words = nullptr;
+    vector<Term> m_terms; // 按 key 排序
+    vector<uint8_t> m_postings;
+    size_t m_postingCount = 0;
+};
+
+#endif
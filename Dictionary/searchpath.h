@@ -0,0 +1,71 @@
+#ifndef SEARCHPATH_H
+#define SEARCHPATH_H
+
+#include "stringkernels.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 精确查找的路径访问者，作为模板参数传给各引擎的 search，编译期决定是否记录路径。
+// 查找每经过一个节点（并与它的键比较）调用一次 visit；不经过新节点的比较（如二分查找最后的相等判断）
+// 调用 compare。键是指向字符串池的视图
+
+// 不记录：纯查找不为路径付出任何代价，visit 内联后什么也不剩
+struct NoPath {
+    void visit(string_view) {}
+    void compare(string_view) {}
+};
+
+// 只记下经过的键的视图，不复制字符串；clear 之后容量保留，反复使用时不再分配内存
+class PathRecorder {
+public:
+    void visit(string_view key) { m_keys.push_back(key); }
+    void compare(string_view) {}
+    void clear() { m_keys.clear(); }
+    size_t size() const { return m_keys.size(); }
+    const vector<string_view>& keys() const { return m_keys; }
+
+    string join(string_view delimiter) const {
+        string result;
+        for (size_t i = 0; i < m_keys.size(); ++i) {
+            if (i > 0) result += delimiter;
+            result += m_keys[i];
+        }
+        return result;
+    }
+
+private:
+    vector<string_view> m_keys;
+};
+
+// 统计一次查找的键比较次数、访问的节点数和比较的字节数。
+// 字节数按字典序逐字节比较到第一个不同字节（含）为止计算，与引擎实际用的比较方式无关，
+// 所以各引擎之间可以直接对比
+class QueryProbe {
+public:
+    explicit QueryProbe(string_view key) : m_key(key) {}
+    void visit(string_view key) {
+        ++m_nodes;
+        compare(key);
+    }
+    void compare(string_view key) {
+        ++m_comparisons;
+        size_t n = min(m_key.size(), key.size());
+        size_t i = firstMismatch(m_key.data(), key.data(), n);
+        m_bytes += i < n ? i + 1 : n;
+    }
+
+    size_t comparisons() const { return m_comparisons; }
+    size_t nodes() const { return m_nodes; }
+    size_t bytesCompared() const { return m_bytes; }
+
+private:
+    string_view m_key;
+    size_t m_comparisons = 0;
+    size_t m_nodes = 0;
+    size_t m_bytes = 0;
+};
+
+#endif
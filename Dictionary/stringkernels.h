@@ -0,0 +1,35 @@
+#ifndef STRINGKERNELS_H
+#define STRINGKERNELS_H
+
+#include <cstddef>
+#include <string_view>
+using namespace std;
+
+// 各引擎比较单词和判断前缀用的内核。按 unsigned char 逐字节比较，结果与 std::string 的顺序一致。
+// x86 上按 CPU 在运行时选用 AVX2（每次 32 字节）或 SSE2（每次 16 字节），标量版本每次比 8 字节；
+// 向量版本只读整块，不足一块的尾部用标量比较，不会越过字符串末尾读内存
+enum class StringKernel { Scalar, Sse2, Avx2 };
+
+const char* kernelName(StringKernel kernel);
+bool kernelSupported(StringKernel kernel);
+// 运行时选中的内核；设置 DICT_SIMD=scalar/sse2/avx2 可强制使用某个（不支持时退回标量）
+StringKernel activeKernel();
+
+// a、b 前 n 个字节中第一个不同字节的位置，全部相同时返回 n
+size_t firstMismatch(const char* a, const char* b, size_t n);
+// 同上，指定内核，供基准对比
+size_t firstMismatch(StringKernel kernel, const char* a, const char* b, size_t n);
+
+// <0、0、>0 分别表示 a 小于、等于、大于 b
+inline int compareBytes(string_view a, string_view b) {
+    size_t n = a.size() < b.size() ? a.size() : b.size();
+    size_t i = firstMismatch(a.data(), b.data(), n);
+    if (i < n) return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+inline bool startsWith(string_view text, string_view prefix) {
+    return prefix.size() <= text.size() && firstMismatch(text.data(), prefix.data(), prefix.size()) == prefix.size();
+}
+
+#endif
@@ -0,0 +1,25 @@
+#include "stringpool.h"
+#include <algorithm>
+#include <cstring>
+
+void StringPool::reserve(size_t bytes) {
+    if (m_chunkCapacity - m_chunkUsed >= bytes) return;
+    m_chunks.emplace_back(new char[bytes]);
+    m_chunkUsed = 0;
+    m_chunkCapacity = bytes;
+}
+
+string_view StringPool::add(string_view text) {
+    if (text.empty()) return {};
+    if (m_chunkCapacity - m_chunkUsed < text.size()) reserve(max(kChunkSize, text.size()));
+    char* dest = m_chunks.back().get() + m_chunkUsed;
+    memcpy(dest, text.data(), text.size());
+    m_chunkUsed += text.size();
+    m_ownedBytes += text.size();
+    return string_view(dest, text.size());
+}
+
+void StringPool::adopt(unique_ptr<MappedFile> file) {
+    m_mappedBytes += file->size();
+    m_mappings.push_back(std::move(file));
+}
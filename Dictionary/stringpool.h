@@ -0,0 +1,39 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "mappedfile.h"
+#include <memory>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// 所有单词和释义只在这里存一份，顺序表和各棵树都只保存指向这里的 string_view。
+// 字符串要么拷贝进池中的大块，要么直接留在池接管的映射文件（索引快照）里
+class StringPool {
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // 预先申请一整块，之后 add 的字符串都放在同一块中
+    void reserve(size_t bytes);
+    string_view add(string_view text);
+    // 接管映射文件，指向其中的视图在池的生命周期内有效
+    void adopt(unique_ptr<MappedFile> file);
+
+    size_t ownedBytes() const { return m_ownedBytes; }    // 拷贝进池的字节
+    size_t mappedBytes() const { return m_mappedBytes; }  // 接管的映射字节
+    size_t allocations() const { return m_chunks.size(); }
+
+private:
+    static const size_t kChunkSize = 1 << 20;
+
+    vector<unique_ptr<char[]>> m_chunks;
+    vector<unique_ptr<MappedFile>> m_mappings;
+    size_t m_chunkUsed = 0;
+    size_t m_chunkCapacity = 0;
+    size_t m_ownedBytes = 0;
+    size_t m_mappedBytes = 0;
+};
+
+#endif
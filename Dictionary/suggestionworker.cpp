@@ -0,0 +1,116 @@
+#include "suggestionworker.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+SuggestionWorker::SuggestionWorker(shared_ptr<const DictionaryIndex> index, QObject* parent)
+    : QObject(parent), m_index(std::move(index)) {
+    m_traceSuggestions = qEnvironmentVariableIsSet("DICT_TRACE_SUGGEST");
+}
+
+void SuggestionWorker::suggest(quint64 generation, const QString& prefix) {
+    // 排队期间又有新的输入，这次请求已经作废
+    if (!isCurrent(generation)) return;
+
+    string key = prefix.toStdString();
+    if (!isReverseQuery(prefix) && WildcardPattern::hasWildcard(key)) {
+        streamPattern(generation, key);
+        return;
+    }
+    auto start = chrono::steady_clock::now();
+    // 输入中有中文时按释义反查英文单词，候选项为“单词  释义”；
+    // 否则按前缀联想，基数树建好前先在有序词表上二分给出候选词
+    vector<string> candidates;
+    if (isReverseQuery(prefix)) {
+        if (m_index->isReady(Engine::Reverse)) {
+            for (const auto& [word, meaning] : m_index->reverseLookup(key)) candidates.push_back(word + "  " + meaning);
+        }
+    } else if (m_index->isReady(Engine::Trie)) {
+        // 新前缀是上一个前缀的延长时只走新增的字符，删除或改动中间的字符时从根重新开始
+        bool extends = m_hasCursor && key.size() >= m_cursorPrefix.size()
+                       && key.compare(0, m_cursorPrefix.size(), m_cursorPrefix) == 0;
+        if (!extends) {
+            m_cursor = {};
+            m_cursorPrefix.clear();
+        }
+        m_index->narrowTrie(m_cursor, string_view(key).substr(m_cursorPrefix.size()));
+        m_cursorPrefix = key;
+        m_hasCursor = true;
+        candidates = m_index->trieCompletions(m_cursor);
+    } else if (m_index->isReady(Engine::SortedArray)) {
+        candidates = m_index->prefixSearchSorted(key);
+    }
+    auto end = chrono::steady_clock::now();
+    if (!isCurrent(generation)) return;
+
+    QStringList words;
+    words.reserve(int(candidates.size()));
+    for (const auto& word : candidates) words.append(QString::fromStdString(word));
+    emit suggestionsReady(generation, words, chrono::duration<double, micro>(end - start).count());
+
+    if (m_traceSuggestions && m_index->isReady(Engine::Trie) && m_index->isReady(Engine::BST)) traceSuggestion(key);
+}
+
+void SuggestionWorker::streamPattern(quint64 generation, const string& pattern) {
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::milliseconds(kPatternBudgetMs);
+    QStringList batch;
+    bool first = true;
+    auto flush = [&]() {
+        if (first) {
+            auto now = chrono::steady_clock::now();
+            emit suggestionsReady(generation, batch, chrono::duration<double, micro>(now - start).count());
+        } else if (!batch.isEmpty()) {
+            emit suggestionsAppended(generation, batch);
+        }
+        first = false;
+        batch.clear();
+    };
+    bool stale = false;
+    int found = 0;
+    auto onMatch = [&](string_view word) {
+        ++found;
+        batch.append(QString::fromUtf8(word.data(), int(word.size())));
+        if (batch.size() >= kPatternBatch) {
+            if (!isCurrent(generation)) {
+                stale = true;
+                return false;
+            }
+            flush();
+        }
+        return found < kMaxPatternResults && chrono::steady_clock::now() < deadline;
+    };
+    // 匹配很少时 onMatch 难得被调用，遍历本身也要按时限和新的输入停下
+    auto shouldStop = [&]() { return !isCurrent(generation) || chrono::steady_clock::now() >= deadline; };
+    m_index->patternSearch(pattern, onMatch, shouldStop);
+    if (stale || !isCurrent(generation)) return;
+    flush();
+
+    if (m_traceSuggestions) {
+        auto end = chrono::steady_clock::now();
+        qDebug().noquote() << QString("模式 \"%1\"：%2 个结果，用时 %3 ms")
+                                  .arg(QString::fromStdString(pattern))
+                                  .arg(found)
+                                  .arg(chrono::duration<double, milli>(end - start).count(), 0, 'f', 1);
+    }
+}
+
+bool SuggestionWorker::isReverseQuery(const QString& text) {
+    return any_of(text.begin(), text.end(), [](QChar c) { return c.unicode() >= 0x80; });
+}
+
+// 同一前缀分别用基数树、二叉树和有序表联想，记录各自耗时
+void SuggestionWorker::traceSuggestion(const string& prefix) const {
+    auto t0 = chrono::steady_clock::now();
+    m_index->prefixSearchTrie(prefix);
+    auto t1 = chrono::steady_clock::now();
+    m_index->prefixSearchBST(m_index->bstRoot(DictionaryIndex::shardOf(prefix)), prefix);
+    auto t2 = chrono::steady_clock::now();
+    m_index->prefixSearchSorted(prefix);
+    auto t3 = chrono::steady_clock::now();
+    qDebug().noquote() << QString("联想 \"%1\"：基数树 %2 µs，二叉树 %3 µs，二分 %4 µs")
+                              .arg(QString::fromStdString(prefix))
+                              .arg(chrono::duration<double, micro>(t1 - t0).count(), 0, 'f', 1)
+                              .arg(chrono::duration<double, micro>(t2 - t1).count(), 0, 'f', 1)
+                              .arg(chrono::duration<double, micro>(t3 - t2).count(), 0, 'f', 1);
+}
@@ -0,0 +1,56 @@
+#ifndef SUGGESTIONWORKER_H
+#define SUGGESTIONWORKER_H
+
+#include "dictionaryindex.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+
+// 在后台线程中做输入联想，界面线程不再等待任何查找。
+// 每次输入都通过 nextGeneration 取得新的代号，之前排队中的请求在开始前被丢弃，
+// 已经开始的请求的结果在发出前被丢弃；界面只接受代号仍是最新的结果
+class SuggestionWorker : public QObject {
+    Q_OBJECT
+public:
+    SuggestionWorker(shared_ptr<const DictionaryIndex> index, QObject* parent = nullptr);
+
+    // 以下两个函数可在任意线程调用
+    quint64 nextGeneration() { return ++m_generation; }
+    bool isCurrent(quint64 generation) const { return generation == m_generation.load(); }
+
+    // 含有非 ASCII 字符的输入按中文释义反查
+    static bool isReverseQuery(const QString& text);
+
+public slots:
+    void suggest(quint64 generation, const QString& prefix);
+
+signals:
+    // searchMicros 为查找本身的耗时，不含排队等待
+    void suggestionsReady(quint64 generation, const QStringList& words, double searchMicros);
+    // 通配符查找在 suggestionsReady 给出第一批之后，陆续追加找到的单词
+    void suggestionsAppended(quint64 generation, const QStringList& words);
+
+private:
+    // 通配符查找可能要走过词表的一大片，边找边分批发出；
+    // 找够 kMaxPatternResults 个、用完 kPatternBudgetMs 或有了新的输入时停止
+    void streamPattern(quint64 generation, const string& pattern);
+    static constexpr int kPatternBatch = 20;
+    static constexpr int kMaxPatternResults = 500;
+    static constexpr int kPatternBudgetMs = 100;
+
+    // 设置 DICT_TRACE_SUGGEST 时，每次联想都把基数树、二叉树和有序表的耗时写入日志
+    void traceSuggestion(const string& prefix) const;
+
+    // 上一次在基数树上联想的前缀和游标，只在工作线程中访问
+    bool m_hasCursor = false;
+    string m_cursorPrefix;
+    DictionaryIndex::TrieCursor m_cursor;
+
+    shared_ptr<const DictionaryIndex> m_index;
+    atomic<quint64> m_generation{0};
+    bool m_traceSuggestions;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "treestats.h"
+#include <QStringList>
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+
+// 按深度的累计量；内部路径长度 I 为各节点深度之和，外部路径长度 E = I + 2n
+struct ShapeSums {
+    size_t nodes = 0;
+    size_t internalPath = 0;
+};
+
+// 可打印的 ASCII 字节原样给出，其余（含 UTF-8 的首字节）写成 0xE4，
+// 单独一个 UTF-8 首字节不是合法的 UTF-8，界面和 JSON 都无法显示
+string shardName(char firstChar) {
+    unsigned char byte = static_cast<unsigned char>(firstChar);
+    if (byte >= 0x20 && byte < 0x7F) return string(1, firstChar);
+    static const char kHex[] = "0123456789ABCDEF";
+    return string("0x") + kHex[byte >> 4] + kHex[byte & 0xF];
+}
+
+int optimalHeightOf(size_t nodes) {
+    int height = 0;
+    while (nodes > 0) {
+        nodes >>= 1;
+        ++height;
+    }
+    return height;
+}
+
+void finish(TreeShape& shape, const ShapeSums& sums) {
+    shape.nodes = sums.nodes;
+    shape.height = shape.maxDepth + 1;
+    shape.optimalHeight = optimalHeightOf(sums.nodes);
+    if (sums.nodes == 0) return;
+    double n = double(sums.nodes);
+    shape.averageDepth = sums.internalPath / n;
+    shape.expectedHit = shape.averageDepth + 1;
+    shape.expectedMiss = (sums.internalPath + 2 * n) / (n + 1);
+}
+
+// 显式栈上的深度优先遍历，栈中同时带着路径上的黑节点数和父节点的颜色
+template <typename Node>
+TreeShape measureTree(const Node* root, ShapeSums& sums) {
+    struct Frame {
+        const Node* node;
+        int depth;
+        int blacks;     // 不含 node 本身
+        bool parentRed;
+    };
+    TreeShape shape;
+    vector<Frame> stack;
+    if (root) stack.push_back({root, 0, 0, false});
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+        const Node* node = frame.node;
+        ++sums.nodes;
+        sums.internalPath += size_t(frame.depth);
+        shape.maxDepth = max(shape.maxDepth, frame.depth);
+        if (size_t(frame.depth) >= shape.depthCounts.size()) shape.depthCounts.resize(frame.depth + 1);
+        ++shape.depthCounts[frame.depth];
+
+        int blacks = frame.blacks;
+        bool red = false;
+        if constexpr (is_same_v<Node, RBNode>) {
+            red = node->isRed;
+            if (red && frame.parentRed) shape.redBlackValid = false;
+            if (!red) ++blacks;
+            // 有空孩子的节点即一条到空位的路径的终点
+            if (!node->left || !node->right) {
+                if (shape.blackHeight < 0) shape.blackHeight = blacks;
+                else if (shape.blackHeight != blacks) shape.redBlackValid = false;
+            }
+        }
+        if (node->right) stack.push_back({node->right, frame.depth + 1, blacks, red});
+        if (node->left) stack.push_back({node->left, frame.depth + 1, blacks, red});
+    }
+    if constexpr (is_same_v<Node, RBNode>) {
+        if (root && root->isRed) shape.redBlackValid = false;
+        if (!root) shape.blackHeight = 0;
+    }
+    return shape;
+}
+
+template <typename Node>
+vector<TreeShape> measureShards(const DictionaryIndex& index, Node* (DictionaryIndex::*rootOf)(char) const) {
+    vector<TreeShape> shapes;
+    TreeShape total;
+    ShapeSums totalSums;
+    for (char firstChar : index.shardKeys()) {
+        ShapeSums sums;
+        TreeShape shape = measureTree<Node>((index.*rootOf)(firstChar), sums);
+        shape.shard = shardName(firstChar);
+        finish(shape, sums);
+
+        totalSums.nodes += sums.nodes;
+        totalSums.internalPath += sums.internalPath;
+        total.maxDepth = max(total.maxDepth, shape.maxDepth);
+        total.redBlackValid = total.redBlackValid && shape.redBlackValid;
+        if (shape.depthCounts.size() > total.depthCounts.size()) total.depthCounts.resize(shape.depthCounts.size());
+        for (size_t depth = 0; depth < shape.depthCounts.size(); ++depth)
+            total.depthCounts[depth] += shape.depthCounts[depth];
+        shapes.push_back(std::move(shape));
+    }
+    // 按首字母分片本身不需要比较，汇总行按全部单词平均；未命中按各分片的空位数合计
+    total.shard = "all";
+    finish(total, totalSums);
+    size_t gaps = totalSums.nodes + shapes.size();
+    if (gaps > 0) total.expectedMiss = (totalSums.internalPath + 2.0 * totalSums.nodes) / double(gaps);
+    total.optimalHeight = 0;
+    for (const TreeShape& shape : shapes) total.optimalHeight = max(total.optimalHeight, shape.optimalHeight);
+    shapes.push_back(std::move(total));
+    return shapes;
+}
+
+} // namespace
+
+vector<TreeShape> treeShapes(const DictionaryIndex& index, Engine engine) {
+    if (!index.isReady(engine)) return {};
+    switch (engine) {
+    case Engine::BST: return measureShards<BSTNode>(index, &DictionaryIndex::bstRoot);
+    case Engine::AVL: return measureShards<AVLNode>(index, &DictionaryIndex::avlRoot);
+    case Engine::RB: return measureShards<RBNode>(index, &DictionaryIndex::rbRoot);
+    case Engine::Sequential:
+    case Engine::SortedArray:
+    case Engine::Trie:
+    case Engine::Eytzinger:
+    case Engine::Fuzzy:
+    case Engine::Reverse:
+    case Engine::Suffix: break;
+    }
+    return {};
+}
+
+QString treeShapeReport(const DictionaryIndex& index) {
+    QStringList lines;
+    for (Engine engine : {Engine::BST, Engine::AVL, Engine::RB}) {
+        vector<TreeShape> shapes = treeShapes(index, engine);
+        if (shapes.empty()) {
+            lines.append(QString("%1：尚未就绪").arg(engineName(engine)));
+            lines.append(QString());
+            continue;
+        }
+        bool redBlack = engine == Engine::RB;
+        const TreeShape& total = shapes.back();
+        lines.append(QString("%1：%2 个分片，%3 个节点，高度 %4（完全平衡 %5），期望比较 命中 %6 次 / 未命中 %7 次%8")
+                         .arg(engineName(engine))
+                         .arg(shapes.size() - 1)
+                         .arg(total.nodes)
+                         .arg(total.height)
+                         .arg(total.optimalHeight)
+                         .arg(total.expectedHit, 0, 'f', 2)
+                         .arg(total.expectedMiss, 0, 'f', 2)
+                         .arg(redBlack && !total.redBlackValid ? "，违反红黑性质" : ""));
+        // 汉字占两列，表头按数值列的宽度手工对齐
+        QString header = "分片     节点   高度 最优 最大深度 平均深度    命中  未命中";
+        if (redBlack) header += " 黑高";
+        lines.append(header);
+        for (const TreeShape& shape : shapes) {
+            QString line = QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                               .arg(QString::fromStdString(shape.shard), -4)
+                               .arg(shape.nodes, 8)
+                               .arg(shape.height, 6)
+                               .arg(shape.optimalHeight, 4)
+                               .arg(shape.maxDepth, 8)
+                               .arg(shape.averageDepth, 8, 'f', 2)
+                               .arg(shape.expectedHit, 7, 'f', 2)
+                               .arg(shape.expectedMiss, 7, 'f', 2);
+            if (redBlack) {
+                line += shape.blackHeight >= 0 ? QString(" %1").arg(shape.blackHeight, 4) : QString(" %1").arg("-", 4);
+                if (!shape.redBlackValid) line += " !";
+            }
+            lines.append(line);
+        }
+        QStringList depths;
+        for (size_t depth = 0; depth < total.depthCounts.size(); ++depth)
+            depths.append(QString("%1:%2").arg(depth).arg(total.depthCounts[depth]));
+        lines.append(QString("深度分布 %1").arg(depths.join(" ")));
+        lines.append(QString());
+    }
+    return lines.join("\n");
+}
@@ -0,0 +1,34 @@
+#ifndef TREESTATS_H
+#define TREESTATS_H
+
+#include "dictionaryindex.h"
+#include <QString>
+#include <string>
+#include <vector>
+using namespace std;
+
+// 树引擎各首字母分片的形状。根的深度为 0，高度为最长路径上的节点数；
+// 树上的查找每经过一个节点比较一次，所以查到深度 d 的单词要比较 d + 1 次。
+// 查不到的期望比较次数假设查询词等概率落在 n + 1 个空位上
+struct TreeShape {
+    string shard;           // 首字母，不可打印的字节写成 0xE4；汇总行为 "all"
+    size_t nodes = 0;
+    int height = 0;
+    int optimalHeight = 0;  // 同样节点数的完全平衡树的高度，ceil(log2(n + 1))
+    int maxDepth = -1;      // 空树为 -1
+    double averageDepth = 0;
+    double expectedHit = 0;  // 查到树中每个单词（等概率）的期望比较次数
+    double expectedMiss = 0; // 查不到时的期望比较次数
+    int blackHeight = -1;    // 红黑树根到空位的路径上的黑节点数（含根），其他树和汇总行为 -1
+    bool redBlackValid = true; // 红黑树：无相邻红节点且各路径黑节点数相同
+    vector<size_t> depthCounts; // 各深度上的节点数
+};
+
+// engine 为 BST、AVL 或 RB 且已就绪时，返回各分片的形状（按首字母排列）和最后一行汇总，否则返回空。
+// 遍历不递归，按文件顺序插入、退化成链表的二叉树也可以统计
+vector<TreeShape> treeShapes(const DictionaryIndex& index, Engine engine);
+
+// 已就绪的各树引擎的形状，分片一行，末尾附汇总行的深度分布；界面和日志使用
+QString treeShapeReport(const DictionaryIndex& index);
+
+#endif